@@ -1,96 +1,335 @@
-import matplotlib.pyplot as plt
-
-data_folder = '../data/'
-plot_folder = '../plots/'
-
-algorithms = [
-    'successor, no compression',
-    'successor, recursive',
-    'successor, 2-pass',
-    'successor, 2-pass, checked',
-    'successor, halving',
-    'union find',
-    'quick find',
-    'successor, 2-pass, microset',
-    'union find, microset',
-    'quick find, microset',
-]
-
-color = {alg: f'C{i}' for i, alg in enumerate(algorithms)}
-for alg in algorithms:
-    if alg.endswith(', microset'):
-        color[alg] = color[alg.removesuffix(', microset')]
-linestyle = {alg: 'dashed' if 'microset' in alg else 'solid' for alg in algorithms}
-
-def load_data(filename):
-    '''Load rows of data from a CSV file, skip comment lines starting with #'''
-
-    with open(data_folder + filename, 'r') as f:
-        return list(eval(line) for line in f)
-
-def figure(data, filename=None, show=False, legend=True, logx=False, logy=False, xlim=None, ylim=None, title=None):
-    '''Plot data from a list of rows, each row is (algorithm, n, total time, query time)'''
-    
-    algs = sorted({row[0] for row in data}, key=lambda x: algorithms.index(x))
-    
-    plt.figure()
-    for algorithm in algs:
-        rows = [row for row in data if row[0] == algorithm]
-        x = [row[2] for row in rows]
-        y = [row[3] / row[2] for row in rows]
-        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=algorithm)
-
-    if logx: 
-        plt.xscale('log')
-    if logy: 
-        plt.yscale('log')
-    plt.xlim(xlim)
-    plt.ylim(ylim)
-    plt.title(title)
-    plt.xlabel('$n$')
-    plt.gca().xaxis.set_label_coords(0.99, -0.025)
-    plt.ylabel('Total time (seconds) / $n$')
-    if legend:
-        plt.legend(frameon=False, loc='upper left')
-    if filename:
-        file = plot_folder + filename
-        print('Saving', file)
-        plt.savefig(file, bbox_inches='tight')
-    if show or not filename:
-        plt.show()
-
-data = load_data('data.csv')      # row = alg, input, n, time
-data.sort(key=lambda row:row[2])  # sort by n
-
-title = r'Delete$(1,\ldots, n)$ + $n$ Succ(1)'
-rows = [row for row in data if row[1] == 'query_one'] # and row[2] <= 65536]
-figure(rows, 'naive-logarithmic.pdf', logx=True, logy=True, xlim=(1, None), show=True, title=title)
-rows = [row for row in data if row[1] == 'query_one' and row[0] != 'successor, no compression']
-figure(rows, 'successor-query-one.pdf', logx=True, ylim=(0,None), legend=False, show=True, title=title)
-
-legend = True
-for p in range(-3, 4):
-    q = f'{1.0 * 2 ** p:.3f}'
-    if p == 0:
-        label = 'n'
-    elif p < 0:
-        label = r'\frac{1}{' + str(2**-p) + '}n'
-    elif p > 0:
-        label = f'{2**p}n'
-    
-    rows = [row for row in data if row[1] == f'worst_case {q}']
-    figure(rows, f'successor-query-worst-case-{q}.pdf', legend=legend, logx=True, ylim=(0,None), show=True,
-           title=r'Delete$(1,\ldots,n)$, $' + label + r'$ Succ(worst)')
-    
-    rows = [row for row in data if row[1] == f'random {q}']
-    figure(rows, f'random-deletion-worst-case-query-{q}.pdf', legend=legend, logx=True, ylim=(0,None), show=True,
-           title=r'$n$ Delete(random), $' + label + r'$ Succ(worst)')
-    legend = False
-
-rows = [row for row in data if row[1] == 'worst_case 1.000']
-figure(rows, f'successor-query-worst-case.pdf', legend=True, logx=True, ylim=(0,None), show=True,
-       title=r'Delete$(1,\ldots,n)$, $n$ Succ(worst)')
-
-rows = [row for row in data if row[1] == 'random 1.000']
-figure(rows, f'random-deletion-worst-case-query.pdf', legend=False, logx=True, ylim=(0,None), show=True,
-       title=r'$n$ Delete(random), $n$ Succ(worst)')
+import matplotlib.pyplot as plt
+
+data_folder = '../data/'
+plot_folder = '../plots/'
+
+algorithms = [
+    'successor, no compression',
+    'successor, recursive',
+    'successor, 2-pass',
+    'successor, 2-pass, checked',
+    'successor, halving',
+    'union find',
+    'quick find',
+    'successor, 2-pass, microset',
+    'union find, microset',
+    'quick find, microset',
+    'microset hierarchy',
+    'successor, 2-pass, blocked',
+    'successor, 2-pass, microset of microsets',
+    'union find, compact',
+    'quick find, compact',
+    'union find, compact, microset',
+    'quick find, compact, microset',
+    'adaptive',
+    'successor, halving, checked',
+    'successor, 2-pass, bounded 4',
+    'successor, 2-pass, every 8th',
+]
+
+variants = {', predecessor': (0, (5, 1)), ', concurrent': (0, (1, 1)), ', batched': 'dotted', ', sorted batched': (0, (1, 3)),
+            ', thp': (0, (3, 1, 1, 1)), ', hugetlb 2MB': (0, (3, 1, 1, 1, 1, 1)), ', hugetlb 1GB': (0, (3, 1, 1, 1, 1, 1, 1, 1)),
+            ', interleaved': (0, (1, 2)), ', aligned': (0, (2, 2)), ', inserts': (0, (4, 1, 1, 1)),
+            ', replay': (0, (5, 2)), ', dispatch': (0, (1, 4)), ', snapshot': (0, (3, 3)), ', sharded': (0, (6, 2)), ', ring': (0, (2, 1)),
+            ', 32-bit': 'dashdot'}  # suffix of algorithm variants in row order -> linestyle
+
+color = {alg: f'C{i}' for i, alg in enumerate(algorithms)}
+for alg in algorithms:
+    if alg.endswith(', microset'):
+        color[alg] = color[alg.removesuffix(', microset')]
+linestyle = {alg: 'dashed' if 'microset' in alg else 'solid' for alg in algorithms}
+for suffix, style in variants.items():
+    for alg in list(algorithms):
+        algorithms.append(alg + suffix)
+        color[alg + suffix] = color[alg]
+        linestyle[alg + suffix] = style
+
+def load_data(filename):
+    '''Load rows of data from a CSV file, skip comment lines starting with #'''
+
+    with open(data_folder + filename, 'r') as f:
+        return list(eval(line) for line in f)
+
+def figure(data, filename=None, show=False, legend=True, logx=False, logy=False, xlim=None, ylim=None, title=None):
+    '''Plot data from a list of rows, each row is (algorithm, n, total time, query time)'''
+    
+    algs = sorted({row[0] for row in data}, key=lambda x: algorithms.index(x))
+    
+    plt.figure()
+    for algorithm in algs:
+        rows = [row for row in data if row[0] == algorithm]
+        x = [row[2] for row in rows]
+        y = [row[3] / row[2] for row in rows]
+        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=algorithm)
+
+    if logx: 
+        plt.xscale('log')
+    if logy: 
+        plt.yscale('log')
+    plt.xlim(xlim)
+    plt.ylim(ylim)
+    plt.title(title)
+    plt.xlabel('$n$')
+    plt.gca().xaxis.set_label_coords(0.99, -0.025)
+    plt.ylabel('Total time (seconds) / $n$')
+    if legend:
+        plt.legend(frameon=False, loc='upper left')
+    if filename:
+        file = plot_folder + filename
+        print('Saving', file)
+        plt.savefig(file, bbox_inches='tight')
+    if show or not filename:
+        plt.show()
+
+def ratio_figure(data, suffix, filename=None, show=False, legend=True, logx=False, ylim=None, title=None):
+    '''Plot the time of each algorithm relative to the time of its variant with suffix'''
+
+    time = {(row[0], row[2]): row[3] for row in data}
+    algs = sorted({row[0].removesuffix(suffix) for row in data if row[0].endswith(suffix)}, key=lambda x: algorithms.index(x))
+
+    plt.figure()
+    for algorithm in algs:
+        x = sorted(n for alg, n in time if alg == algorithm and (algorithm + suffix, n) in time)
+        y = [time[(algorithm, n)] / time[(algorithm + suffix, n)] for n in x]
+        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=algorithm)
+
+    if logx: 
+        plt.xscale('log')
+    plt.ylim(ylim)
+    plt.title(title)
+    plt.xlabel('$n$')
+    plt.gca().xaxis.set_label_coords(0.99, -0.025)
+    plt.ylabel('Time / time' + suffix.replace(',', ''))
+    if legend:
+        plt.legend(frameon=False, loc='upper left')
+    if filename:
+        file = plot_folder + filename
+        print('Saving', file)
+        plt.savefig(file, bbox_inches='tight')
+    if show or not filename:
+        plt.show()
+
+def scaling_figure(data, input, filename=None, show=False, legend=True, title=None, unit='threads'):
+    '''Plot throughput relative to one thread for all rows with input "input, t threads", or "input, t unit"'''
+
+    rows = [row for row in data if row[1].startswith(input + ', ') and row[1].endswith(' ' + unit)]
+    threads = lambda row: int(row[1].split()[-2])
+    time = {(row[0], row[2], threads(row)): row[3] for row in rows}
+    
+    plt.figure()
+    for algorithm, n in sorted({(alg, n) for alg, n, t in time if t == 1}, key=lambda x: (algorithms.index(x[0]), x[1])):
+        x = sorted(t for alg, m, t in time if alg == algorithm and m == n)
+        y = [time[(algorithm, n, 1)] / time[(algorithm, n, t)] for t in x]
+        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=f'{algorithm}, $n={n}$')
+
+    plt.xscale('log', base=2)
+    plt.title(title)
+    plt.xlabel(unit.capitalize())
+    plt.gca().xaxis.set_label_coords(0.99, -0.025)
+    plt.ylabel('Throughput / throughput with one thread')
+    if legend:
+        plt.legend(frameon=False, loc='upper left')
+    if filename:
+        file = plot_folder + filename
+        print('Saving', file)
+        plt.savefig(file, bbox_inches='tight')
+    if show or not filename:
+        plt.show()
+
+def counter_figure(data, counter, filename=None, show=False, legend=True, title=None):
+    '''Plot a hardware counter per element for rows with counters, row = (algorithm, input, n, time, counters)'''
+
+    rows = [row for row in data if len(row) > 4 and counter in row[4]]
+    if not rows:
+        return
+    algs = sorted({row[0] for row in rows}, key=lambda x: algorithms.index(x))
+
+    plt.figure()
+    for algorithm in algs:
+        x = [row[2] for row in rows if row[0] == algorithm]
+        y = [row[4][counter] / row[2] for row in rows if row[0] == algorithm]
+        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=algorithm)
+
+    plt.xscale('log')
+    plt.ylim(0, None)
+    plt.title(title)
+    plt.xlabel('$n$')
+    plt.gca().xaxis.set_label_coords(0.99, -0.025)
+    plt.ylabel(counter.replace('_', ' ').capitalize() + ' / $n$')
+    if legend:
+        plt.legend(frameon=False, loc='upper left')
+    if filename:
+        file = plot_folder + filename
+        print('Saving', file)
+        plt.savefig(file, bbox_inches='tight')
+    if show or not filename:
+        plt.show()
+
+def latency_figure(data, input, filename=None, show=False, legend=True, title=None):
+    '''Plot mean and tail latencies for rows with input "input", row = (algorithm, input, n, mean, percentiles)'''
+
+    rows = [row for row in data if row[1] == input]
+    if not rows:
+        return
+    algs = sorted({row[0] for row in rows}, key=lambda x: algorithms.index(x))
+
+    plt.figure()
+    for algorithm in algs:
+        x = [row[2] for row in rows if row[0] == algorithm]
+        y = [row[4]['p99.9'] for row in rows if row[0] == algorithm]
+        plt.plot(x, y, '.', color=color[algorithm], linestyle=linestyle[algorithm], label=algorithm)
+        y = [row[3] for row in rows if row[0] == algorithm]
+        plt.plot(x, y, color=color[algorithm], linestyle=linestyle[algorithm], alpha=0.3)
+
+    plt.xscale('log')
+    plt.yscale('log')
+    plt.title(title)
+    plt.xlabel('$n$')
+    plt.gca().xaxis.set_label_coords(0.99, -0.025)
+    plt.ylabel('Latency (seconds), p99.9 and mean')
+    if legend:
+        plt.legend(frameon=False, loc='upper left')
+    if filename:
+        file = plot_folder + filename
+        print('Saving', file)
+        plt.savefig(file, bbox_inches='tight')
+    if show or not filename:
+        plt.show()
+
+data = load_data('data.csv')      # row = alg, input, n, time[, counters]
+data.sort(key=lambda row:row[2])  # sort by n
+
+title = r'Delete$(1,\ldots, n)$ + $n$ Succ(1)'
+rows = [row for row in data if row[1] == 'query_one'] # and row[2] <= 65536]
+figure(rows, 'naive-logarithmic.pdf', logx=True, logy=True, xlim=(1, None), show=True, title=title)
+rows = [row for row in data if row[1] == 'query_one' and row[0] != 'successor, no compression']
+figure(rows, 'successor-query-one.pdf', logx=True, ylim=(0,None), legend=False, show=True, title=title)
+
+legend = True
+for p in range(-3, 4):
+    q = f'{1.0 * 2 ** p:.3f}'
+    if p == 0:
+        label = 'n'
+    elif p < 0:
+        label = r'\frac{1}{' + str(2**-p) + '}n'
+    elif p > 0:
+        label = f'{2**p}n'
+    
+    rows = [row for row in data if row[1] == f'worst_case {q}']
+    figure(rows, f'successor-query-worst-case-{q}.pdf', legend=legend, logx=True, ylim=(0,None), show=True,
+           title=r'Delete$(1,\ldots,n)$, $' + label + r'$ Succ(worst)')
+    
+    rows = [row for row in data if row[1] == f'random {q}']
+    figure(rows, f'random-deletion-worst-case-query-{q}.pdf', legend=legend, logx=True, ylim=(0,None), show=True,
+           title=r'$n$ Delete(random), $' + label + r'$ Succ(worst)')
+    legend = False
+
+rows = [row for row in data if row[1] == 'worst_case 1.000']
+figure(rows, f'successor-query-worst-case.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'Delete$(1,\ldots,n)$, $n$ Succ(worst)')
+
+rows = [row for row in data if row[1] == 'random 1.000']
+figure(rows, f'random-deletion-worst-case-query.pdf', legend=False, logx=True, ylim=(0,None), show=True,
+       title=r'$n$ Delete(random), $n$ Succ(worst)')
+
+rows = [row for row in data if row[1] == 'random 1.000, sets']
+figure(rows, f'random-deletion-many-sets.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'$2^{22}/n$ sets, $n$ Delete(random), $n$ Succ(worst)')
+
+batched = {row[0].removesuffix(', batched') for row in data if row[0].endswith(', batched')}
+for q, filename, title in [('query_one', 'batched-query-one.pdf', r'Delete$(1,\ldots, n)$ + $n$ Succ(1)'), 
+                           ('random 8.000', 'batched-random.pdf', r'$n$ Delete(random), $8n$ Succ(worst)')]:
+    rows = [row for row in data if row[1] == q and row[0].removesuffix(', batched') in batched]
+    figure(rows, filename, legend=True, logx=True, ylim=(0,None), show=True, title=title)
+
+rows = [row for row in data if row[1] == 'random 1.000, range 16']
+figure(rows, 'random-deletion-range.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'$n$ Delete(random), $n$ Range(worst, 16)')
+
+rows = [row for row in data if row[1] == 'random 1.000']
+rows += [(row[0] + ', inserts', *row[1:]) for row in data if row[1] == 'random 1.000, inserts']
+figure(rows, 'random-deletion-inserts.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'$n$ Delete(random), $n$ Succ(worst), with and without $n/2$ Insert')
+
+for q, title in [('zipf', r'$n/2$ allocations with Zipf hints'), ('frontier', r'$n$ Delete(random) + $n$ next-fit allocations'),
+                 ('window 1024', r'$n$ allocations in a sliding window of 1024'), ('lifo', r'$2n$ Zipf allocations / LIFO Insert')]:
+    rows = [row for row in data if row[1] == q]
+    figure(rows, f'allocator-{q.replace(" ", "-")}.pdf', legend=True, logx=True, ylim=(0,None), show=True, title=title)
+
+rows = [row for row in data if row[1] == 'stream 1.000']
+figure(rows, 'stream-deletion.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'$n$ Delete(random), $n$ Succ(random), streamed')
+
+rows = [row for row in data if row[1] == 'sparse 8.000']
+figure(rows, 'sparse-deletion.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'Delete(all but $n/16$ random), $8n$ Succ(random)')
+
+for q, filename, title in [('extents 128', 'extent-deletion-range.pdf', r'$n/128$ DeleteRange(random, 128), $n$ Succ(worst)'),
+                           ('extents 128, elements', 'extent-deletion-elements.pdf', r'$n/128 \times 128$ Delete(extent), $n$ Succ(worst)')]:
+    rows = [row for row in data if row[1] == q]
+    figure(rows, filename, legend=True, logx=True, ylim=(0,None), show=True, title=title)
+
+rows = [row for row in data if row[1] == 'worst_case 1.000']
+ratio_figure(rows, ', 32-bit', 'successor-query-worst-case-32-bit.pdf', logx=True, show=True,
+             title=r'Delete$(1,\ldots,n)$, $n$ Succ(worst), 64-bit vs 32-bit')
+
+rows = [row for row in data if row[1] == 'random 1.000']
+ratio_figure(rows, ', 32-bit', 'random-deletion-worst-case-query-32-bit.pdf', legend=False, logx=True, show=True,
+             title=r'$n$ Delete(random), $n$ Succ(worst), 64-bit vs 32-bit')
+
+for suffix, name in [(', replay', 'replay'), (', dispatch', 'dispatch')]:
+    rows = [row for row in data if row[1] == 'random 1.000']
+    ratio_figure(rows, suffix, f'random-deletion-worst-case-query-{name}.pdf', logx=True, show=True,
+                 title=rf'$n$ Delete(random), $n$ Succ(worst), time_it vs {suffix[2:]}')
+
+for suffix, name in [(', thp', 'thp'), (', hugetlb 2MB', 'hugetlb-2MB'), (', hugetlb 1GB', 'hugetlb-1GB')]:
+    rows = [row for row in data if row[1] == 'random 1.000']
+    ratio_figure(rows, suffix, f'random-deletion-worst-case-query-{name}.pdf', logx=True, show=True,
+                 title=rf'$n$ Delete(random), $n$ Succ(worst), default pages vs {suffix[2:]}')
+
+rows = [row for row in data if row[1] == 'mixed 1.000']
+figure(rows, f'mixed-successor-predecessor.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+       title=r'$n$ Delete(random), $n$ Succ/Pred(worst)')
+
+scaling_figure(data, 'random 1.000', 'concurrent-scaling.pdf', show=True,
+               title=r'$n$ Delete(random), $n$ Succ(worst), concurrent')
+
+scaling_figure(data, 'random 1.000, sharded', 'sharded-scaling.pdf', show=True,
+               title=r'$n$ Delete(random), $n$ Succ(worst), threads owning shards')
+
+scaling_figure(data, 'random 8.000', 'readers-scaling.pdf', show=True, unit='readers',
+               title=r'$n$ Delete(random) by one writer, $8n$ Succ(worst) by readers')
+
+for q, filename, title in [('build 0.125', 'bulk-build.pdf', r'Build from bitmap, density $1/8$'), 
+                           ('replay 0.125', 'bulk-replay.pdf', r'Init + Delete(absent), density $1/8$')]:
+    rows = [row for row in data if row[1] == q]
+    figure(rows, filename, legend=True, logx=True, ylim=(0,None), show=True, title=title)
+
+rows = [row for row in data if row[1] == 'random 1.000' and row[0] in ('successor, 2-pass', 'successor, 2-pass, microset')]
+for counter in ['cache_misses', 'dtlb_misses', 'branch_misses', 'instructions']:
+    counter_figure(rows, counter, f'random-deletion-{counter.replace("_", "-")}.pdf', show=True, 
+                   title=rf'$n$ Delete(random), $n$ Succ(worst), {counter.replace("_", " ")}')
+
+rows = [row for row in data if row[1] == 'random 1.000']
+for counter, title in [('bytes', 'bytes allocated'), ('links', 'links followed by Succ'), 
+                       ('writes', 'pointers written by compression'), ('dirty', 'cache lines written by compression')]:
+    counter_figure(rows, counter, f'random-deletion-{counter}.pdf', show=True, 
+                   title=rf'$n$ Delete(random), $n$ Succ(worst), {title}')
+
+for q, name, title in [('worst_case 1.000', 'worst-case', r'Delete$(1,\ldots,n)$, $n$ Succ(worst)'), 
+                       ('random 1.000', 'random-deletion', r'$n$ Delete(random), $n$ Succ(worst)')]:
+    for op in ['successor', 'delete']:
+        latency_figure(data, f'{q}, {op} latency', f'{name}-{op}-latency.pdf', show=True, title=f'{title}, {op} latency')
+
+policies = ['successor, 2-pass', 'successor, halving', 'successor, halving, checked', 
+            'successor, 2-pass, bounded 4', 'successor, 2-pass, every 8th']
+for q, name, title in [('worst_case 1.000', 'worst-case', r'Delete$(1,\ldots,n)$, $n$ Succ(worst)'), 
+                       ('random 8.000', 'random-deletion', r'$n$ Delete(random), $8n$ Succ(worst)')]:
+    rows = [row for row in data if row[1] == q and row[0] in policies]
+    figure(rows, f'{name}-compression-policies.pdf', legend=True, logx=True, ylim=(0,None), show=True,
+           title=f'{title}, compression policies')
+    counter_figure(rows, 'dirty', f'{name}-compression-policies-dirty.pdf', show=True, 
+                   title=f'{title}, cache lines written by compression')
+    rows = [row for row in data if row[1] == f'{q}, successor latency' and row[0] in policies]
+    latency_figure(rows, f'{q}, successor latency', f'{name}-compression-policies-latency.pdf', show=True, 
+                   title=f'{title}, successor latency')
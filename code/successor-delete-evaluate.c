@@ -1,775 +1,6162 @@
-// ================================================================
-//
-//   Source code for the experimental results contained in the paper:
-//
-//     "A Simple Integer Successor-Delete Data Structure", 
-//     by Gerth Stølting Brodal.
-//     23rd Symposium on Experimental Algorithm (SEA 2025)
-//
-//   Evaluates the running time of various data structures supporting 
-//   successor and delete operations on an initial set of integers 
-//   {0, ..., n+1}, where the entries 0 and n+1, should not be deleted.
-//
-// ================================================================
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
-#include <assert.h>
-
-typedef long long int value;  // 64 bit values for set elements
-
-const value WORD_SIZE = 8 * sizeof(value);  // number of bits in value
-const value MIN_N = 2;                      // min input size
-const value MAX_N = 1 << 22;                // max set size n
-const value MAX_OPERATIONS = 9 * MAX_N + 1; // max operations in test
-const double MIN_TEST_TIME = 1.0;           // min test time
-const value MIN_REPEATS = 5;                // min number of repeats in a timing
-const value BEST_OF = 3;                    // timing repeats
-const char *DATAFILE = "../data/data.csv";  // output file
-
-typedef struct {
-    char *name;
-    void (*init)(value);
-    void (*delete)(value);
-    value (*successor)(value);
-} Algorithm;
-
-// ================================================================
-//   Successor-delete data structure from pseudocodes in the paper
-// ================================================================
-
-value *A;  // global successor-delete array
-
-void allocate(value max_n) {
-    A = malloc((max_n + 2) * sizeof(value));
-}
-
-void init(value n) {
-    for (value i = 0; i < n + 2; i++) {
-        A[i] = i;
-    }
-}
-
-void delete(value i) {
-    A[i] = i + 1;
-}
-
-void delete_checked(value i) {
-    if (A[i] == i) {
-        A[i] = i + 1;
-    }
-}
-
-value successor_naive(value i) {
-    // no path compression
-    while (i < A[i]) { 
-        i = A[i];
-    }
-    return i;
-}
-
-value successor_recursive(value i) {
-    // recursive path compression
-    if (i < A[i]) {
-        A[i] = successor_recursive(A[i]);
-    }
-    return A[i];
-}
-
-value successor_2pass(value i) {
-    // 2-pass path compression
-    value r = i;
-    while (r < A[r]) {
-        r = A[r];
-    }
-    while (A[i] < r) {
-        value i_next = A[i];
-        A[i] = r;
-        i = i_next;
-    }
-    return r;
-}
-
-value successor_halving(value i) {
-    // path halving (1-pass)
-    while (i < A[i]) {
-        i = A[i] = A[A[i]];
-    }
-    return i;
-}
-
-const Algorithm alg_naive = {"successor, no compression", init, delete, successor_naive};
-const Algorithm alg_recursive = {"successor, recursive", init, delete, successor_recursive};
-const Algorithm alg_2pass = {"successor, 2-pass", init, delete, successor_2pass};
-const Algorithm alg_2pass_checked = {"successor, 2-pass, checked", init, delete_checked, successor_2pass};
-const Algorithm alg_halving = {"successor, halving", init, delete, successor_halving};
-
-// ================================================================
-//  Weighted quick-find union-find data structure (McIlroy and Morris)
-// ================================================================
-
-typedef struct { value root, weight, succ; } QF_node;
-
-QF_node *QF;  // global quick-find data structure
-
-void QF_allocate(value max_n) {
-    QF = malloc((max_n + 2) * sizeof(QF_node));
-}
-
-void QF_init(value n) {
-    for (value i = 0; i < n + 2; i++) {
-        QF[i].root = i;
-        QF[i].weight = 1;
-        QF[i].succ = i;
-    }
-}
-
-value QF_successor(value i) {
-    return QF[QF[i].root].succ;
-}
-
-void QF_delete(value i) {
-    if (QF[QF[i].root].succ == i) {  // i == succ(i), i.e., i is not deleted
-        value r1 = QF[i].root, r2 = QF[i+1].root;
-        if (QF[r1].weight <= QF[r2].weight) {
-            QF[r2].weight += QF[r1].weight;
-            for (value r=i; QF[r].root == r1; r--) QF[r].root = r2;
-        } else {
-            QF[r1].succ = QF[r2].succ;
-            QF[r1].weight += QF[r2].weight;
-            for (value r=i+1; QF[r].root == r2; r++) QF[r].root = r1;
-        }
-    }
-}   
-
-const Algorithm alg_quick_find = {"quick find", QF_init, QF_delete, QF_successor};
-
-// ================================================================
-//  Union-find data structure with union by weight and 2-pass path compression
-// ================================================================
-
-typedef struct { value parent, weight, succ; } UF_node;
-
-UF_node *UF;  // global union-find data structure
-
-void UF_allocate(value max_n) {
-    UF = malloc((max_n + 2) * sizeof(UF_node));
-}
-
-void UF_init(value n) {
-    for (value i = 0; i < n + 2; i++) {
-        UF[i].parent = i;
-        UF[i].weight = 1;
-        UF[i].succ = i;
-    }
-}
-
-value UF_find(value i) {
-    value r = i;
-    while (UF[r].parent != r) {
-        r = UF[r].parent;
-    }
-    while (i != r) {
-        value p = UF[i].parent;
-        UF[i].parent = r;
-        i = p;
-    }   
-    return r;
-}
-
-void UF_union(value i, value j) {
-    value r1 = UF_find(i);
-    value r2 = UF_find(j);
-    if (r1 == r2) {
-        return;
-    }
-    if (UF[r1].weight <= UF[r2].weight) {
-        UF[r2].weight += UF[r1].weight;
-        UF[r1].parent = r2;
-    } else {
-        UF[r1].weight += UF[r2].weight;
-        UF[r2].parent = r1;
-        UF[r1].succ = UF[r2].succ;
-    }    
-}
-
-value UF_successor(value i) {
-    return UF[UF_find(i)].succ;
-}
-
-void UF_delete(value i) {
-    UF_union(i, i + 1);
-}   
-
-const Algorithm alg_union_find = {"union find", UF_init, UF_delete, UF_successor};
-
-// ================================================================
-//  Generic successor-delete structure with mircosets
-// ================================================================
-
-value *microsets;               // global array of microsets
-const Algorithm *alg_macroset;  // algorithm to use for macroset structure
-
-void microset_allocate(value max_n) {
-    value n_buckets = (max_n + 2 + WORD_SIZE - 1) / WORD_SIZE;
-    microsets = malloc(n_buckets * sizeof(value));  
-}
-
-void microset_init(value n) {
-    value n_buckets = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
-    alg_macroset->init(n_buckets);
-    for (value i = 0; i < n_buckets; i++) {
-        microsets[i] = (value) -1;  // all ones
-    }
-}
-
-void microset_delete(value i) {
-    value bucket = i / WORD_SIZE;
-    value bit = i % WORD_SIZE;
-    value mask = (value) 1 << bit;
-    if (microsets[bucket] & mask) {
-        microsets[bucket] ^= mask;
-        if (microsets[bucket] == 0) {
-            alg_macroset->delete(bucket);
-        }
-    }
-}
-
-value microset_successor(value i) {
-    value bucket = i / WORD_SIZE;
-    value bit = i % WORD_SIZE;
-    value mask = (value) 1 << bit;
-
-    value W = microsets[bucket];
-    value high_bits = W & ~(((value)1 << bit) - 1);
-    if (high_bits) {
-        return bucket * WORD_SIZE + __builtin_ctzll(high_bits);
-    } else {
-        value succ_bucket = alg_macroset->successor(bucket + 1);
-        return succ_bucket * WORD_SIZE + __builtin_ctzll(microsets[succ_bucket]);
-    }
-}
-
-void QF_microset_init(value n) {
-    alg_macroset = &alg_quick_find;
-    microset_init(n);
-}
-
-void UF_microset_init(value n) {
-    alg_macroset = &alg_union_find;
-    microset_init(n);
-}
-
-void DS_microset_init(value n) {
-    alg_macroset = &alg_2pass;
-    microset_init(n);
-}
-
-const Algorithm alg_qf_microset = {"quick find, microset", QF_microset_init, microset_delete, microset_successor};
-const Algorithm alg_uf_microset = {"union find, microset", UF_microset_init, microset_delete, microset_successor};
-const Algorithm alg_ds_microset = {"successor, 2-pass, microset", DS_microset_init, microset_delete, microset_successor};
-
-// ================================================================
-//   Successor-delete data structure from pseudocode in the paper 
-//   modified to maintain reverse pointers and heights of subtrees;
-//   T_deepest_node() returns a node with maximum depth
-// ================================================================
-
-typedef struct {
-    value parent;       // parent node, i,e, A[i] >= i
-    value height;       // height of subtree rooted at this node
-    value next, prev;   // double-linked list of all nodes with equal height
-    value left, right;  // double-linked list of siblings
-    value child;        // left-most child
-} successor_delete_node;
-
-successor_delete_node *nodes;  // global successor-delete array
-value *roots;           // roots[height] = a node with height h
-value max_height;       // max height of all trees
-
-void T_allocate(value max_n) {
-    nodes = malloc((max_n + 2) * sizeof(successor_delete_node));
-    roots = malloc((max_n + 2) * sizeof(value));
-}
-
-void T_init(value n) {
-    // Initialize the successor-delete structure to n + 2 singleton trees
-    for (value i = 0; i < n + 2; i++) {
-        nodes[i].parent = i;
-        nodes[i].height = 0;
-        nodes[i].left = i;
-        nodes[i].right = i;
-        nodes[i].child = -1;
-        nodes[i].next = i + 1;
-        nodes[i].prev = i - 1;
-        roots[i] = -1;
-    }
-    nodes[0].prev = n + 1;
-    nodes[n + 1].next = 0;
-    max_height = 0;
-    roots[0] = 0;
-}
-
-value T_height(value i) {
-    // Compute the height of the tree rooted at i, assuming children heights are known
-    value child = nodes[i].child;
-    if (child == -1) {
-        return 0;
-    }
-    value c = child;
-    value ch = nodes[c].height;
-    while (nodes[c].right != child) {
-        c = nodes[c].right;
-        if (nodes[c].height > ch) {
-            ch = nodes[c].height;
-        }
-    }
-    return 1 + ch;
-}
-
-void T_fix_height(value i) {
-    // Recompute height of node i, and update the lists nodes of equal height
-    value h = nodes[i].height;
-    value next = nodes[i].next;
-    value prev = nodes[i].prev;
-    if (roots[h] == i) {
-        roots[h] = next != i ? next : -1;
-    }
-    if (next != i) {
-        nodes[next].prev = prev;
-        nodes[prev].next = next;
-        nodes[i].next = i;
-        nodes[i].prev = i;
-    }
-    h = T_height(i);
-    nodes[i].height = h;
-    if (roots[h] != -1) {
-        next = roots[h];
-        prev = nodes[next].prev;
-        nodes[i].next = next;   
-        nodes[i].prev = prev;
-        nodes[next].prev = i;
-        nodes[prev].next = i;
-    }
-    roots[h] = i;
-}
-
-void T_link(value i, value j) {
-    // Make i leftmost child of j
-    assert(nodes[i].parent == i);
-    value right = nodes[j].child;
-    nodes[j].child = i;
-    nodes[i].parent = j;
-    if (right >= 0) {
-        value left = nodes[right].left;
-        nodes[i].right = right;
-        nodes[i].left = left;
-        nodes[right].left = i;
-        nodes[left].right = i;
-    }
-}
-
-void T_unlink(value i) {
-    // Remove i from the child list of its parent
-    value j = nodes[i].parent;
-    assert(j > i);
-    value left = nodes[i].left;
-    value right = nodes[i].right;
-    if (nodes[j].child == i) {
-        nodes[j].child = right != i ? right : -1;
-    }
-    nodes[left].right = right;
-    nodes[right].left = left;
-    nodes[i].parent = i;
-    nodes[i].left = i;
-    nodes[i].right = i;
-}
-
-void T_delete(value i) {
-    value j = nodes[i].parent;
-    if (j > i) {
-        // Unlink i and fix the height of all previous ancestors of i
-        T_unlink(i);
-        T_fix_height(j);
-        while (nodes[j].parent != j) {
-            j = nodes[j].parent;
-            T_fix_height(j);
-        }
-    }
-    j = i + 1;
-    T_link(i, j);
-    // Fix the height of all new ancestors of i
-    T_fix_height(j);
-    while (nodes[j].parent != j) {
-        j = nodes[j].parent;
-        T_fix_height(j);
-    }
-    // Adjust max_height, if it has increased
-    if (nodes[j].height > max_height) {
-        max_height = nodes[j].height;
-    }
-}
-
-value T_successor(value i) {
-    // 2-pass path compression
-    value root = i;
-    // Find root
-    while (root < nodes[root].parent) {
-        root = nodes[root].parent;
-    }
-    // Path compression
-    while (i < root) {
-        value parent = nodes[i].parent;
-        T_unlink(i);
-        T_link(i, root);
-        T_fix_height(i);
-        i = parent;
-    }
-    T_fix_height(root);
-    // Adjust max_height, if it has decreased
-    while (roots[max_height] == -1) {
-        max_height--;
-    }
-    return root;
-}    
-
-value T_deepest_leaf(value i) {
-    // Find a deepest node in tree rooted at i
-    value h = nodes[i].height;
-    while (h > 0) {
-        h--;
-        i = nodes[i].child; 
-        while (nodes[i].height != h) {
-            i = nodes[i].right;
-        }    
-    }    
-    return i;
-}    
-
-value T_deepest_node() {
-    // Return a node with maximum depth
-    return T_deepest_leaf(roots[max_height]);
-}    
-
-void T_validate(value n) {
-    // Validate integrity of all nodes
-    value uncounted_children = 0;
-    for (value i=0; i < n + 2; i++) {
-        value parent = nodes[i].parent, 
-              child = nodes[i].child, 
-              next = nodes[i].next, 
-              prev = nodes[i].prev, 
-              left = nodes[i].left, 
-              right = nodes[i].right, 
-              height = nodes[i].height;
-        assert(i <= parent && parent < n + 2);
-        if (parent != i) {
-            uncounted_children++;   
-        }
-        assert(height >= 0);
-        if (height == 0) {
-            assert(child == - 1);
-        } else {
-            assert(0 <= child && child < i);
-            value c = child;
-            value ch = nodes[c].height;
-            assert(nodes[c].parent == i);
-            uncounted_children--;
-            while (nodes[c].right != child) {
-                c = nodes[c].right;
-                assert(nodes[c].parent == i);
-                uncounted_children--;
-                if (nodes[c].height > ch) {
-                    ch = nodes[c].height;
-                }
-            }
-            assert(height == ch + 1);
-        }
-        assert(0 <= next && next < n + 2);
-        assert(0 <= prev && prev < n + 2);
-        assert(nodes[next].prev == i);
-        assert(nodes[prev].next == i);
-        assert(height == nodes[next].height);
-        assert(height == nodes[prev].height);
-        
-        assert(0 <= left && left < n + 2);
-        assert(0 <= right && right < n + 2);
-        assert(nodes[right].left == i);
-        assert(nodes[left].right == i);
-        assert(nodes[right].parent == parent);
-        assert(nodes[left].parent == parent);
-    }
-    value nodes_found = 0;
-    for (value h = 0; h <= max_height; h++) {
-        value root = roots[h];
-        assert(0 <= roots && root < n + 2);
-        assert(nodes[root].height == h);
-        nodes_found++;
-        while (nodes[root].next != roots[h]) {
-            root = nodes[root].next;
-            assert(nodes[root].height == h);
-            nodes_found++;
-        }
-    }
-    assert(uncounted_children == 0);
-    assert(nodes_found == n + 2);
-}
-
-// ================================================================
-//  Struct to store test data = sequence of operations
-// ================================================================
-
-struct {
-    value n;        // initial set size {1,...,n}
-    char name[100]; // text buffer for name of the current test data
-    value *input;   // successor(x) for x >= 1, delete(-x) for x <= - 1, 0 = end
-    value *output;  // answers to all input operations, 0 for delete
-} data;
-
-void data_allocate(value max_m) {
-    data.input = malloc((max_m + 1) * sizeof(value));
-    data.output = malloc((max_m + 1) * sizeof(value));
-}
-
-void data_set_output(const Algorithm *alg) {
-    // Set data.output using data.input and algorithm alg
-    value n = data.n;
-    alg->init(n);
-    value *out = data.output;
-    for (value *p = data.input; *p != 0; p++) {
-        value x = *p;
-        if (x > 0) {
-            *(out++) = alg->successor(x);
-        } else {
-            *(out++) = 0;
-            alg->delete(-x);
-        }
-    }
-}
-
-void validate(const Algorithm *alg) {
-    // Check if successor-delete algorithm alg generates correct output    
-    alg->init(data.n);
-    for (value *in=data.input, *out=data.output; *in != 0; in++, out++) {
-        value x = *in;
-        if (x >= 0) {
-            assert(*out == alg->successor(x));
-        } else {
-            assert(*out == 0);
-            assert(1 <= -x <= data.n);
-            alg->delete(-x);
-        }
-    }
-}
-
-// ================================================================
-//   Various test input sequences
-// ================================================================
-
-void data_query_one(value n) {
-    // Create sequence Delete(1), ..., Delete(n), n x Succ(1)
-    printf("Creating Succ(1) input: n = %d\n", n);
-    assert(2 * n <= MAX_OPERATIONS);
-    data.n = n;
-    sprintf(data.name, "query_one");
-    value *p = data.input;
-    for (value i=1; i <= n; i++, p++) {
-        *p = -i;
-    }
-    for (value i=1; i <= n; i++, p++) {
-        *p = 1;
-    }
-    *p = 0;
-    data_set_output(&alg_2pass);
-}
-
-void data_worst_case(value n, double queries_per_deletion) {
-    // Create sequence Delete(1), ..., Delete(n), interleaved with worst-case queries
-    printf("Creating worst-case input: n = %d, alpha = %.3f\n", n, queries_per_deletion);
-    assert(1 + n * (1 + queries_per_deletion) <= MAX_OPERATIONS);
-    data.n = n;
-    sprintf(data.name, "worst_case %.3f", queries_per_deletion);
-    value *p = data.input;
-    T_init(n);
-    value queries = 0;
-    for (value i = 1; i <= n; i++) {
-        T_delete(i);
-        *(p++) = -i;
-        while (queries < i * queries_per_deletion) {
-            value j = T_deepest_node();
-            T_successor(j);
-            *(p++) = j;
-            queries += 1;
-        }
-    }
-    *p = 0;
-    data_set_output(&alg_2pass);
-}
-
-unsigned long long random64() {
-    // Generate a random 64-bit integer
-    value x = 0;
-    for (int i = 0; i < 8; i++) {
-        x = (x << 8) | (rand() & 255);
-    }
-    return x;
-}
-
-void data_random(value n, double queries_per_deletion) {
-    // Create sequence with n random Delete, interleaved with worst-case queries
-    printf("Creating random input: n = %d, alpha = %.3f\n", n, queries_per_deletion);
-    assert(1 + n * (1 + queries_per_deletion) <= MAX_OPERATIONS);
-    data.n = n;
-    sprintf(data.name, "random %.3f", queries_per_deletion);
-    value *p = data.input;
-    T_init(n);
-    value queries = 0;
-    for (value i = 1; i <= n; i++) {
-        value d = random64() % (n - 1) + 1;
-        T_delete(d);
-        *(p++) = -d;
-        while (queries < i * queries_per_deletion) {
-            value j = T_deepest_node();
-            successor_2pass(j);
-            *(p++) = j;
-            queries += 1;
-        }
-    }
-    *p = 0;
-    data_set_output(&alg_2pass);
-}
-
-// ================================================================
-//  List of algorithms evaluated
-// ================================================================
-
-const int n_algorithms = 10;
-const Algorithm algorithms[10] = {
-    alg_naive, 
-    alg_recursive, 
-    alg_2pass, 
-    alg_2pass_checked, 
-    alg_halving, 
-    alg_quick_find, 
-    alg_union_find,
-    alg_qf_microset,
-    alg_uf_microset,
-    alg_ds_microset
-};
-
-// ================================================================
-//  Timing functions
-// ================================================================
-
-value trash = 0;  // xor of all successor results, avoid compiler optimization
-
-void time_it(const Algorithm *alg, const char *data_filename) {
-    // Time the algorithm alg on the test data in data.input
-    validate(alg);  // check if algorithm generates correct output before timing
-
-    void (*init)(value)       = alg->init;
-    void (*delete)(value)     = alg->delete;
-    value (*successor)(value) = alg->successor;
-    value n                   = data.n;
-    value *input              = data.input;
-
-    printf("\"%s\", \"%s\", %d, ", alg->name, data.name, n);
-    fflush(stdout);
-    double seconds = 1e100;
-    double best_time = 1e100;
-    int r = 0, repeats = MIN_REPEATS;
-    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
-        clock_t start = clock();
-        while (1) {
-            for (; r < repeats; r++) {
-                init(n);
-                for (value *in = input; *in != 0; in++) {
-                    value x = *in;
-                    if (x >= 0) {
-                        trash ^= successor(x);
-                    } else {
-                        delete(-x);
-                    }
-                }
-            }
-            clock_t end = clock();
-            seconds = ((double) (end - start)) / CLOCKS_PER_SEC;
-            if (seconds >= MIN_TEST_TIME) break;
-            repeats *= 2;
-        }
-        seconds /= r;
-        if (seconds < best_time) {
-            best_time = seconds;
-        }
-    }
-    printf("%.10e\n", best_time);
-    FILE *data_file = fopen(data_filename, "a");
-    fprintf(data_file, "\"%s\", \"%s\", %d, %.10e\n", alg->name, data.name, n, best_time);
-    fclose(data_file);
-}
-
-void time_query_one() {
-    //  Run tests Delete(1), ..., Delete(n), n x Succ(1)
-    for (value n = MIN_N; n <= MAX_N; n *= 2) {
-        data_query_one(n);
-        for (int s = 0; s < n_algorithms; s++) {
-            if (s == 0 && n > 65536) {
-                continue;  // naive algorithm too slow
-            }
-            if (s == 1 && n > 65536) {
-                continue;  // recursion limit exceeded for recursive path compression
-            }
-            time_it(&algorithms[s], DATAFILE);
-        }
-    }
-}
-
-void time_worst_case() {
-    // Run tests Delete(1), ..., Delete(n), interleaved with worst-case queries
-    for (value n = MIN_N; n <= MAX_N; n *= 2) {
-        for (double q = 1.0 / 8; q <= 8; q *= 2) {
-            data_worst_case(n, q);
-            for (int s = 1; s < n_algorithms; s++) {
-                time_it(&algorithms[s], DATAFILE);
-            }
-        }
-    }
-}
-
-void time_random() {
-    // Run tests with n random Delete, interleaved with worst-case queries
-    for (value n = MIN_N; n <= MAX_N; n *= 2) {
-        for (double q = 1.0 / 8; q <= 8; q *= 2) {
-            data_random(n, q);
-            for (int s = 1; s < n_algorithms; s++) {
-                time_it(&algorithms[s], DATAFILE);
-            }
-        }
-    }
-}
-
-// ================================================================
-//   Main
-// ================================================================
-
-int main() {
-    printf("Values are %d byte integers\n", sizeof(value));
-    
-    // Allocate space for all global data structures
-    allocate(MAX_N);
-    T_allocate(MAX_N);
-    QF_allocate(MAX_N);
-    UF_allocate(MAX_N);
-    microset_allocate(MAX_N);
-    data_allocate(MAX_OPERATIONS);
-
-    // Run all tests
-    time_random();
-    time_query_one();
-    time_worst_case();
-
-    printf("Trash (ignore): %d\n", trash);
-}
-
-// ================================================================
+// ================================================================
+//
+//   Source code for the experimental results contained in the paper:
+//
+//     "A Simple Integer Successor-Delete Data Structure", 
+//     by Gerth Stølting Brodal.
+//     23rd Symposium on Experimental Algorithm (SEA 2025)
+//
+//   Evaluates the running time of various data structures supporting 
+//   successor and delete operations on an initial set of integers 
+//   {0, ..., n+1}, where the entries 0 and n+1, should not be deleted.
+//
+//   Compile with: gcc -O3 -pthread successor-delete-evaluate.c
+//
+// ================================================================
+
+#define _GNU_SOURCE  // sched_setaffinity
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sched.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // rdtsc and the SIMD microset scans
+#endif
+
+// Compile with -DVALUE_BITS=32 for 32 bit set elements (n < 2^31 - 1), 
+// rows of timings are then marked ", 32-bit" in the data file
+#ifndef VALUE_BITS
+#define VALUE_BITS 64
+#endif
+
+#if VALUE_BITS == 32
+typedef int value;            // 32 bit values for set elements
+#define VALUE_FORMAT "%d"
+#define VALUE_SUFFIX ", 32-bit"
+#else
+typedef long long int value;  // 64 bit values for set elements
+#define VALUE_FORMAT "%lld"
+#define VALUE_SUFFIX ""
+#endif
+
+typedef unsigned long long word;  // 64 bit words for microsets
+
+const value OP_INSERT = (value) 1 << (8 * sizeof(value) - 2); // Insert(x) is x | OP_INSERT in test data
+const value OP_PRED = (value) 1 << (8 * sizeof(value) - 3);  // Pred(x) is x | OP_PRED in test data
+const value OP_RANGE = (value) 1 << (8 * sizeof(value) - 4); // DeleteRange(l, r) is -range_op(l, r) in test data
+const int RANGE_SHIFT = 8 * sizeof(value) / 2;               // l < 2^RANGE_SHIFT, r - l < OP_RANGE >> RANGE_SHIFT
+
+const value WORD_SIZE = 8 * sizeof(word);   // number of bits in word
+const value MIN_N = 2;                      // min input size
+value MAX_N = 1 << 22;                      // max set size n, option -N
+value MAX_OPERATIONS;                       // max operations in test, 9 * MAX_N + 1
+double MIN_TEST_TIME = 1.0;                 // min test time, option -T
+const value MIN_REPEATS = 5;                // min number of repeats in a timing
+const value BEST_OF = 3;                    // timing repeats
+const char *DATAFILE = "../data/data.csv";  // output file, option -o
+const char *STOREFILE = "../data/successor-delete.store";  // file for persistent structures, removed after tests
+const char *TRACEFILE = "../data/successor-delete.trace";  // file for trace replay tests, removed after tests
+const char *TRACE_FOLDER = NULL;            // folder caching generated test data as traces, NULL = none, option -c
+const char *REPLAY_TRACE = NULL;            // recorded trace replayed by the traces test, NULL = none, option -R
+const value BUILD_MIN_N = 1 << 20;          // min set size in bulk construction tests
+value BUILD_MAX_N = 1 << 26;                // max set size in bulk construction tests, option -B
+const value THREADS_MIN_N = 1 << 10;        // min set size in concurrent tests
+const value SETS_MIN_N = 1 << 6;            // min set size in tests with many sets
+const value SETS_MAX_N = 1 << 16;           // max set size in tests with many sets
+const value STREAM_MIN_N = 1 << 20;         // min set size in streamed tests
+value STREAM_MAX_N = (value) 1 << 26;       // max set size in streamed tests, option -S
+#define BATCH_SIZE 64                       // max operations in a batch
+#define BATCH_WIDTH 8                       // queries interleaved in a batched successor
+#define MAX_LEVELS 8                        // max levels in a microset hierarchy
+#define MAX_THREADS 64                      // max threads in concurrent tests
+#define RING_SIZE 1024                      // max queries submitted to a ring and not yet reaped
+#define RING_WIDTH 32                       // max queries in flight in a ring
+#define LATENCY_BATCH 16                    // max operations timed together in latency histograms
+#define RANGE_K 16                          // elements reported by range queries in range tests
+#define PARALLEL_MIN_WORDS 1024             // min words per thread in parallel bulk construction
+
+// Compile with -DLATENCY_HISTOGRAMS to also record latency histograms of
+// successor and delete operations in the worst-case and random tests
+#ifdef LATENCY_HISTOGRAMS
+const int LATENCY = 1;
+#else
+const int LATENCY = 0;
+#endif
+
+// Compile with -DOPERATION_COUNTS to also count the links followed, and the
+// pointers and cache lines written by path compression, in the successor 
+// queries of the tests timed by time_it, see record_counts
+#ifdef OPERATION_COUNTS
+const int COUNTS = 1;
+#else
+const int COUNTS = 0;
+#endif
+unsigned long long count_links = 0;   // nodes a query moved to along a path
+unsigned long long count_writes = 0;  // pointers written by path compressions
+unsigned long long count_dirty = 0;   // cache lines written by path compressions
+size_t count_line = 0;                // cache line of the last write
+
+void count_write(const void *p) {
+    // Count a pointer written at p, and its cache line if different from the
+    // line of the previous write, i.e., consecutive writes to the same line
+    // along a path only dirty it once
+    size_t line = (size_t) p / 64;
+    count_writes++;
+    count_dirty += line != count_line;
+    count_line = line;
+}
+
+typedef struct {
+    value q, i, next;  // query, current node (-1 = not started, answer when done), and algorithm state
+} successor_state;
+
+typedef struct {
+    char *name;
+    void *(*create)(value);             // allocate a structure for sets of size up to max_n
+    void (*destroy)(void *);            // release a structure
+    void (*init)(void *, value);        // initialize structure to the set {0, ..., n+1}
+    void (*delete)(void *, value);
+    value (*successor)(void *, value);
+    void (*successor_batch)(void *, const value *, value *, size_t);  // optional
+    void (*delete_batch)(void *, const value *, size_t);              // optional
+    value (*predecessor)(void *, value);                              // optional
+    int concurrent;                   // delete and successor can be called concurrently
+    void (*build)(void *, value, const word *);  // optional, initialize to the set in a bitmap
+    void (*successor_range)(void *, value, value *, size_t);          // optional, see batch_range
+    void (*successor_sorted)(void *, const value *, value *, size_t); // optional, successor_batch for sorted queries
+    void (*delete_range)(void *, value, value);                       // optional, delete all of [l, r]
+    void (*insert)(void *, value);    // optional, undelete i in {1, ..., n}, making the structure fully dynamic
+    value (*replay)(void *, const value *);  // optional, perform successor and delete operations until 0 by 
+                                             // direct calls, returns the xor of the answers
+    value max_n;                      // optional, max set size supported, 0 = unbounded
+    value (*snapshot_successor)(void *, value);  // optional, successor in the last published snapshot, for 
+                                                 // concurrent readers while one thread does all other operations
+    void (*publish)(void *);                     // optional, publish the deletes to snapshot_successor
+    int sharded;                      // concurrent if the operations on elements in each shard, see
+                                      // element_shard, are performed by a single thread
+    int (*successor_step)(void *, successor_state *);  // optional, one pointer-chase step of successor(q),
+                                                       // returns 1 when done, see ring_poll
+} Algorithm;
+
+void batch_successor(const Algorithm *alg, void *S, const value *q, value *out, size_t k) {
+    // out[j] = successor(q[j]) for j < k, using successor_batch if available
+    if (alg->successor_batch) {
+        alg->successor_batch(S, q, out, k);
+    } else {
+        for (size_t j = 0; j < k; j++) {
+            out[j] = alg->successor(S, q[j]);
+        }
+    }
+}
+
+void batch_range(const Algorithm *alg, void *S, value n, value i, value *out, size_t k) {
+    // out[j] = the j-th smallest element >= i for j < k, where the elements 
+    // after n + 1 are n + 1, using successor_range if available
+    if (alg->successor_range) {
+        alg->successor_range(S, i, out, k);
+    } else {
+        for (size_t j = 0; j < k; j++) {
+            out[j] = j == 0 ? alg->successor(S, i) : out[j - 1] == n + 1 ? n + 1 : alg->successor(S, out[j - 1] + 1);
+        }
+    }
+}
+
+void batch_successor_sorted(const Algorithm *alg, void *S, const value *q, value *out, size_t k) {
+    // out[j] = successor(q[j]) for j < k, where q[0] <= ... <= q[k - 1], 
+    // using successor_sorted if available
+    if (alg->successor_sorted) {
+        alg->successor_sorted(S, q, out, k);
+    } else {
+        batch_successor(alg, S, q, out, k);
+    }
+}
+
+void batch_delete(const Algorithm *alg, void *S, const value *q, size_t k) {
+    // delete(q[j]) for j < k, using delete_batch if available
+    if (alg->delete_batch) {
+        alg->delete_batch(S, q, k);
+    } else {
+        for (size_t j = 0; j < k; j++) {
+            alg->delete(S, q[j]);
+        }
+    }
+}
+
+void batch_delete_range(const Algorithm *alg, void *S, value l, value r) {
+    // delete(i) for l <= i <= r, using delete_range if available
+    if (alg->delete_range) {
+        alg->delete_range(S, l, r);
+    } else {
+        for (value i = l; i <= r; i++) {
+            alg->delete(S, i);
+        }
+    }
+}
+
+// ================================================================
+//  Submission and completion rings of successor queries, for callers 
+//  receiving queries in bursts that can tolerate some added latency.
+//  Queries are submitted with a tag, and completed out of order as 
+//  (tag, answer) entries. Up to RING_WIDTH queries are in flight as 
+//  state machines advanced by successor_step in round-robin, one 
+//  pointer-chase step per query per round, where a completed query is 
+//  replaced at once, i.e., unlike successor_batch a long path does not 
+//  hold back the queries behind it. Consecutive submissions of the same 
+//  query share one query in flight, since otherwise each copy would walk
+//  the same uncompressed path. Without successor_step, runs of up to 
+//  BATCH_SIZE submitted queries are completed by batch_successor. 
+//  Deletions must wait for ring_drain.
+// ================================================================
+
+typedef struct { value tag, x; } ring_entry;  // x = query when submitted, answer when completed
+
+typedef struct {
+    const Algorithm *alg;
+    void *S;
+    ring_entry submitted[RING_SIZE], completed[RING_SIZE];  // indexed by counts modulo RING_SIZE
+    unsigned long long n_submitted, n_started, n_completed, n_reaped;
+    unsigned long long n_released;  // submitted entries before n_released are not read again, see ring_release
+    successor_state flight[RING_WIDTH];  // the queries in flight
+    unsigned long long flight_first[RING_WIDTH];  // submitted[flight_first, + flight_count) have the query
+    int flight_count[RING_WIDTH];
+    int in_flight;
+} successor_ring;
+
+void ring_init(successor_ring *R, const Algorithm *alg, void *S) {
+    R->alg = alg;
+    R->S = S;
+    R->n_submitted = R->n_started = R->n_completed = R->n_reaped = R->n_released = 0;
+    R->in_flight = 0;
+}
+
+void ring_release(successor_ring *R) {
+    // Update n_released to the first submitted entry not started or with a
+    // query in flight, where the tags of the entries are read on completion
+    R->n_released = R->n_started;
+    for (int j = 0; j < R->in_flight; j++) {
+        if (R->flight_first[j] < R->n_released) {
+            R->n_released = R->flight_first[j];
+        }
+    }
+}
+
+int ring_submit(successor_ring *R, value i, value tag) {
+    // Submit the query successor(i) with tag, returns 0 if the ring is full,
+    // i.e., RING_SIZE queries are submitted and not reaped, or the oldest
+    // query in flight was submitted RING_SIZE queries ago
+    if (R->n_submitted - R->n_reaped == RING_SIZE || R->n_submitted - R->n_released == RING_SIZE) {
+        return 0;
+    }
+    R->submitted[R->n_submitted++ % RING_SIZE] = (ring_entry) {tag, i};
+    return 1;
+}
+
+void ring_poll(successor_ring *R) {
+    // Advance each query in flight by one step, and start submitted queries
+    // in the free slots, or without successor_step, complete the next run 
+    // of submitted queries
+    if (R->alg->successor_step == NULL) {
+        value q[BATCH_SIZE], out[BATCH_SIZE];
+        size_t k = 0;
+        for (; k < BATCH_SIZE && R->n_started + k < R->n_submitted; k++) {
+            q[k] = R->submitted[(R->n_started + k) % RING_SIZE].x;
+        }
+        batch_successor(R->alg, R->S, q, out, k);
+        for (size_t j = 0; j < k; j++) {
+            R->completed[R->n_completed++ % RING_SIZE] = (ring_entry) {R->submitted[R->n_started++ % RING_SIZE].tag, out[j]};
+        }
+        R->n_released = R->n_started;
+        return;
+    }
+    for (int j = 0; j < R->in_flight; ) {
+        if (R->alg->successor_step(R->S, &R->flight[j])) {
+            // complete, and move the last query in flight to slot j
+            for (int c = 0; c < R->flight_count[j]; c++) {
+                value tag = R->submitted[(R->flight_first[j] + c) % RING_SIZE].tag;
+                R->completed[R->n_completed++ % RING_SIZE] = (ring_entry) {tag, R->flight[j].i};
+            }
+            int last = --R->in_flight;
+            R->flight[j] = R->flight[last];
+            R->flight_first[j] = R->flight_first[last];
+            R->flight_count[j] = R->flight_count[last];
+        } else {
+            j++;
+        }
+    }
+    while (R->n_started < R->n_submitted) {
+        // a query submitted right after the same query shares its slot
+        value q = R->submitted[R->n_started % RING_SIZE].x;
+        int last = R->in_flight - 1;
+        if (last >= 0 && R->flight[last].q == q && R->flight_first[last] + R->flight_count[last] == R->n_started) {
+            R->flight_count[last]++;
+        } else if (R->in_flight < RING_WIDTH) {
+            R->flight[R->in_flight] = (successor_state) {q, -1, -1};
+            R->flight_first[R->in_flight] = R->n_started;
+            R->flight_count[R->in_flight++] = 1;
+        } else {
+            break;
+        }
+        R->n_started++;
+    }
+    ring_release(R);
+}
+
+void ring_drain(successor_ring *R) {
+    // Complete all submitted queries
+    while (R->n_completed < R->n_submitted) {
+        ring_poll(R);
+    }
+}
+
+size_t ring_complete(successor_ring *R, ring_entry *out, size_t k) {
+    // Reap up to k completed queries into out, returns the number reaped
+    size_t j = 0;
+    for (; j < k && R->n_reaped < R->n_completed; j++) {
+        out[j] = R->completed[R->n_reaped++ % RING_SIZE];
+    }
+    return j;
+}
+
+unsigned long long splitmix64(unsigned long long *state) {
+    // Fast seeded pseudo-random 64-bit integer (Steele, Lea and Flood)
+    unsigned long long z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// ================================================================
+//   Memory allocation policies for the arrays of the structures, where
+//   arrays of at least MAPPED_MIN_SIZE bytes can be mapped with mmap on
+//   transparent huge pages (madvise), on reserved 2 MB or 1 GB huge pages 
+//   (MAP_HUGETLB), and be interleaved among NUMA nodes (mbind), instead 
+//   of the default malloc with first-touch NUMA placement. The policy is
+//   appended to the algorithm names in the rows, see ROW_SUFFIX.
+// ================================================================
+
+#define PAGES_DEFAULT 0    // malloc, pages of the system default size
+#define PAGES_THP 1        // transparent 2 MB huge pages
+#define PAGES_HUGETLB_2MB 2
+#define PAGES_HUGETLB_1GB 3
+int MEMORY_PAGES = PAGES_DEFAULT;  // option -m
+int MEMORY_INTERLEAVE = 0;         // interleave mapped arrays among all NUMA nodes, option -m
+int MEMORY_ALIGN = 0;              // cache line align arrays allocated by malloc, option -m
+const size_t MAPPED_MIN_SIZE = 1 << 20;
+const char *memory_pages_names[4] = {"", ", thp", ", hugetlb 2MB", ", hugetlb 1GB"};
+char ROW_SUFFIX[100] = VALUE_SUFFIX;  // appended to algorithm names in rows, see memory_policy
+
+typedef struct mapping {
+    void *p;
+    size_t size;
+    struct mapping *next;
+} mapping;
+
+mapping *mappings = NULL;  // list of arrays allocated by memory_map
+
+size_t memory_page_size() {
+    return MEMORY_PAGES == PAGES_HUGETLB_1GB ? 1 << 30 : MEMORY_PAGES == PAGES_DEFAULT ? 4096 : 1 << 21;
+}
+
+#define MAX_NODES 1024  // max NUMA nodes in the mbind mask
+
+int memory_nodes(unsigned long *nodes) {
+    // Set the bits of the online NUMA nodes in the MAX_NODES bit mask nodes,
+    // from a list like 0-3,8 in /sys/devices/system/node/online, and return
+    // the highest node + 1, or 0 if the list is unavailable
+    memset(nodes, 0, MAX_NODES / 8);
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (f == NULL) {
+        return 0;
+    }
+    int highest = -1, first, last;
+    while (fscanf(f, "%d", &first) == 1) {
+        last = first;
+        int c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%d", &last) != 1) {
+                break;
+            }
+            c = fgetc(f);
+        }
+        for (int node = first; node <= last && node < MAX_NODES; node++) {
+            nodes[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+            highest = node > highest ? node : highest;
+        }
+        if (c != ',') {
+            break;
+        }
+    }
+    fclose(f);
+    return highest + 1;
+}
+
+void *memory_map(size_t size) {
+    // Map zeroed memory according to the policy, NULL on failure
+    size_t page = memory_page_size();
+    size = (size + page - 1) / page * page;
+    char *p = MAP_FAILED;
+    if (MEMORY_PAGES == PAGES_HUGETLB_2MB || MEMORY_PAGES == PAGES_HUGETLB_1GB) {
+#ifdef MAP_HUGETLB
+        int shift = MEMORY_PAGES == PAGES_HUGETLB_1GB ? 30 : 21;
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+#endif
+    } else {
+        // Map an extra page to align the array to a page boundary
+        p = mmap(NULL, size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            size_t head = (page - (size_t) p % page) % page;
+            if (head > 0) {
+                munmap(p, head);
+            }
+            munmap(p + head + size, page - head);
+            p += head;
+        }
+#ifdef MADV_HUGEPAGE
+        if (p != MAP_FAILED && MEMORY_PAGES == PAGES_THP) {
+            madvise(p, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (p == MAP_FAILED) {
+        return NULL;
+    }
+#if defined(__linux__) && defined(SYS_mbind)
+    if (MEMORY_INTERLEAVE) {
+        // Before the first touch, interleave the pages over the online nodes
+        unsigned long nodes[MAX_NODES / (8 * sizeof(unsigned long))];
+        int n_nodes = memory_nodes(nodes);
+        if (n_nodes == 0 || syscall(SYS_mbind, p, size, 3 /* MPOL_INTERLEAVE */, nodes, n_nodes + 1, 0) != 0) {
+            fprintf(stderr, "Interleaving %zu bytes over the online NUMA nodes failed\n", size);
+            exit(EXIT_FAILURE);
+        }
+    }
+#endif
+    mapping *m = malloc(sizeof(mapping));
+    *m = (mapping) {p, size, mappings};
+    mappings = m;
+    return p;
+}
+
+void *policy_malloc(size_t size, int zero) {
+    // Allocate an array according to the policy, zeroed if zero
+    if ((MEMORY_PAGES != PAGES_DEFAULT || MEMORY_INTERLEAVE) && size >= MAPPED_MIN_SIZE) {
+        void *p = memory_map(size);
+        if (p == NULL) {
+            fprintf(stderr, "Mapping %zu bytes with policy \"%s\" failed, see /proc/sys/vm/nr_hugepages\n", size, ROW_SUFFIX);
+            exit(EXIT_FAILURE);
+        }
+        return p;
+    }
+    if (MEMORY_ALIGN) {
+        void *p;
+        int error = posix_memalign(&p, 64, size);
+        if (error != 0) {
+            fprintf(stderr, "Aligned allocation of %zu bytes failed: %s\n", size, strerror(error));
+            exit(EXIT_FAILURE);
+        }
+        return zero ? memset(p, 0, size) : p;
+    }
+    void *p = zero ? calloc(1, size) : malloc(size);
+    if (p == NULL && size > 0) {
+        fprintf(stderr, "Allocating %zu bytes failed\n", size);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+int policy_free(void *p) {
+    // Unmap p if allocated by memory_map, returns 1 if p was unmapped
+    for (mapping **m = &mappings; *m != NULL; m = &(*m)->next) {
+        if ((*m)->p == p) {
+            mapping *found = *m;
+            munmap(found->p, found->size);
+            *m = found->next;
+            free(found);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void memory_policy(const char *policies) {
+    // Set the policy from a comma separated list of thp, hugetlb2m,
+    // hugetlb1g, interleave and align, and set ROW_SUFFIX accordingly
+    char copy[200];
+    snprintf(copy, sizeof(copy), "%s", policies);
+    for (char *policy = strtok(copy, ","); policy != NULL; policy = strtok(NULL, ",")) {
+        if (strcmp(policy, "thp") == 0) {
+            MEMORY_PAGES = PAGES_THP;
+        } else if (strcmp(policy, "hugetlb2m") == 0) {
+            MEMORY_PAGES = PAGES_HUGETLB_2MB;
+        } else if (strcmp(policy, "hugetlb1g") == 0) {
+            MEMORY_PAGES = PAGES_HUGETLB_1GB;
+        } else if (strcmp(policy, "interleave") == 0) {
+            MEMORY_INTERLEAVE = 1;
+        } else if (strcmp(policy, "align") == 0) {
+            MEMORY_ALIGN = 1;
+        } else {
+            fprintf(stderr, "Unknown memory policy: %s\n", policy);
+            exit(EXIT_FAILURE);
+        }
+    }
+    snprintf(ROW_SUFFIX, sizeof(ROW_SUFFIX), "%s%s%s%s", memory_pages_names[MEMORY_PAGES],
+             MEMORY_INTERLEAVE ? ", interleaved" : "", MEMORY_ALIGN ? ", aligned" : "", VALUE_SUFFIX);
+}
+
+// ================================================================
+//   Memory-mapped persistent structures, where the create function of
+//   an algorithm allocates from a file mapped with mmap, so that deletes
+//   and path compressions write through to the page cache and a restart 
+//   is a remap of the file instead of init(n) and a replay of deletes.
+//
+//   Durability guarantees:
+//   - store_open marks the file dirty and msyncs the header before
+//     returning, i.e., before any operation modifies the structure.
+//   - store_sync msyncs the structure, so that the writeback left for
+//     store_close is bounded, but leaves the file dirty.
+//   - store_close msyncs the structure, then marks the file clean and
+//     msyncs the header. Only a clean file is reopened.
+//   - A dirty file, e.g., after a crash of the process or the system,
+//     may contain a partially written operation, and is therefore 
+//     reinitialized to {0, ..., n+1} by store_open.
+//   A persistent structure must be released by store_close, not destroy.
+// ================================================================
+
+typedef struct {
+    char magic[8];     // STORE_MAGIC
+    int value_bits;    // VALUE_BITS of the program writing the file
+    int clean;         // structure on disk is consistent
+    char name[64];     // name of the algorithm
+    value max_n, n;
+    size_t size;       // bytes in the file
+    size_t used;       // bytes allocated by create
+} store_header;
+
+typedef struct store {
+    store_header *header;  // start of the mapping
+    int fd;
+    int reopened;          // structure was remapped, not initialized
+    size_t next;           // offset of next allocation by create
+    void *S;               // handle of the structure
+    struct store *next_store;
+} store;
+
+const char STORE_MAGIC[8] = "SUCCDEL";
+const size_t STORE_ALIGN = 64;  // allocations are cache line aligned
+
+store *store_allocating = NULL;  // store that create is currently allocating from
+store *stores = NULL;            // list of open stores
+
+int store_contains(const store *P, const void *p) {
+    return (char *) p >= (char *) P->header && (char *) p < (char *) P->header + P->header->size;
+}
+
+size_t memory_allocated = 0;  // bytes allocated by memory_malloc, memory_calloc and memory_aligned
+
+void *memory_malloc(size_t size) {
+    // malloc, or the next bytes of the store create is allocating from,
+    // which are zero in a new file and unchanged in a reopened file
+    store *P = store_allocating;
+    memory_allocated += size;
+    if (P == NULL) {
+        return policy_malloc(size, 0);
+    }
+    void *p = (char *) P->header + P->next;
+    P->next += (size + STORE_ALIGN - 1) / STORE_ALIGN * STORE_ALIGN;
+    if (P->next > P->header->size) {
+        fprintf(stderr, "Structure does not fit in the %zu bytes of the store, see store_size\n", P->header->size);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void *memory_calloc(size_t count, size_t size) {
+    if (store_allocating) {
+        return memory_malloc(count * size);
+    }
+    memory_allocated += count * size;
+    return policy_malloc(count * size, 1);
+}
+
+void *memory_aligned(size_t size) {
+    // Cache line aligned memory_malloc, for handles with padded fields
+    if (store_allocating) {
+        return memory_malloc(size);
+    }
+    memory_allocated += size;
+    void *p = aligned_alloc(64, (size + 63) / 64 * 64);
+    if (p == NULL) {
+        fprintf(stderr, "Allocating %zu aligned bytes failed\n", size);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void memory_free(void *p) {
+    // free or unmap, unless p is in a store that is released by store_close
+    for (store *P = stores; P != NULL; P = P->next_store) {
+        if (store_contains(P, p)) {
+            return;
+        }
+    }
+    if (!policy_free(p)) {
+        free(p);
+    }
+}
+
+size_t store_size(value max_n) {
+    // Bytes reserved for a structure, sufficient for all algorithms, where
+    // the file is sparse and only pages touched are backed by the disk
+    return STORE_ALIGN * 64 + 4 * (max_n + 3) * sizeof(value) + (1 << 20);
+}
+
+void store_mark(store *P, int clean) {
+    P->header->clean = clean;
+    msync(P->header, sizeof(store_header), MS_SYNC);
+}
+
+store *store_open(const char *filename, const Algorithm *alg, value max_n, value n) {
+    // Open the structure for alg stored in filename, and remap it if the file
+    // is clean and contains alg for max_n and n, otherwise create the file
+    // and initialize alg to {0, ..., n+1}. Returns NULL on failure.
+    store *P = malloc(sizeof(store));
+    P->fd = open(filename, O_RDWR | O_CREAT, 0644);
+    if (P->fd < 0) {
+        free(P);
+        return NULL;
+    }
+    store_header old = {0};
+    P->reopened = pread(P->fd, &old, sizeof(old), 0) == sizeof(old)
+        && memcmp(old.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0
+        && old.value_bits == VALUE_BITS && old.clean
+        && strncmp(old.name, alg->name, sizeof(old.name)) == 0
+        && old.max_n == max_n && old.n == n;
+    size_t size = P->reopened ? old.size : store_size(max_n);
+    if (!P->reopened && (ftruncate(P->fd, 0) != 0 || ftruncate(P->fd, size) != 0)) {
+        close(P->fd);
+        free(P);
+        return NULL;
+    }
+    P->header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, P->fd, 0);
+    if (P->header == MAP_FAILED) {
+        close(P->fd);
+        free(P);
+        return NULL;
+    }
+    if (!P->reopened) {
+        memcpy(P->header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+        P->header->value_bits = VALUE_BITS;
+        strncpy(P->header->name, alg->name, sizeof(P->header->name) - 1);
+        P->header->max_n = max_n;
+        P->header->n = n;
+        P->header->size = size;
+    }
+    store_mark(P, 0);
+    // Allocations by create are deterministic, so on reopen create sets the
+    // pointers of the handles to the same offsets in the new mapping
+    P->next = (sizeof(store_header) + STORE_ALIGN - 1) / STORE_ALIGN * STORE_ALIGN;
+    store_allocating = P;
+    P->S = alg->create(max_n);
+    store_allocating = NULL;
+    assert(!P->reopened || P->next == P->header->used);
+    P->header->used = P->next;
+    if (!P->reopened) {
+        alg->init(P->S, n);
+    }
+    P->next_store = stores;
+    stores = P;
+    return P;
+}
+
+void store_sync(store *P) {
+    // Write the structure to disk, the file remains dirty
+    msync(P->header, P->header->used, MS_SYNC);
+}
+
+void store_close(store *P) {
+    // Write the structure to disk and mark the file clean
+    store_sync(P);
+    store_mark(P, 1);
+    store **q = &stores;
+    while (*q != P) {
+        q = &(*q)->next_store;
+    }
+    *q = P->next_store;
+    munmap(P->header, P->header->size);
+    close(P->fd);
+    free(P);
+}
+
+// ================================================================
+//   Parallel bulk construction from a bitmap, where bit i % WORD_SIZE
+//   of bits[i / WORD_SIZE] is set if and only if i is in the set; 
+//   bits 0 and n + 1 must be set
+// ================================================================
+
+typedef struct {
+    void (*f)(void *, int, value, value);
+    void *arg;
+    int t;
+    value begin, end;
+} parallel_task;
+
+void *parallel_run(void *arg) {
+    parallel_task *task = arg;
+    task->f(task->arg, task->t, task->begin, task->end);
+    return NULL;
+}
+
+int parallel_threads(value n) {
+    // Number of threads to use for a parallel loop over n words
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (threads > n / PARALLEL_MIN_WORDS) threads = n / PARALLEL_MIN_WORDS;
+    return threads < 1 ? 1 : threads;
+}
+
+void parallel_for(int threads, value n, void (*f)(void *, int, value, value), void *arg) {
+    // Call f(arg, t, begin, end) in parallel for the ranges [begin, end) 
+    // of [0, n) of thread t = 0, ..., threads - 1
+    pthread_t thread[MAX_THREADS];
+    parallel_task task[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        task[t] = (parallel_task) {f, arg, t, (long long) n * t / threads, (long long) n * (t + 1) / threads};
+        if (t > 0) {
+            pthread_create(&thread[t], NULL, parallel_run, &task[t]);
+        }
+    }
+    parallel_run(&task[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(thread[t], NULL);
+    }
+}
+
+typedef struct {
+    const word *bits;
+    void (*visit)(void *, value, value);  // visit(S, p, s) for interval (p, s]
+    void *S;
+    value last[MAX_THREADS];  // last element in the words of thread t, or -1
+} intervals_task;
+
+void intervals_last(void *arg, int t, value begin, value end) {
+    intervals_task *task = arg;
+    task->last[t] = -1;
+    for (value w = end - 1; w >= begin; w--) {
+        if (task->bits[w]) {
+            task->last[t] = w * WORD_SIZE + WORD_SIZE - 1 - __builtin_clzll(task->bits[w]);
+            return;
+        }
+    }
+}
+
+void intervals_visit(void *arg, int t, value begin, value end) {
+    intervals_task *task = arg;
+    value p = -1;
+    for (int u = t - 1; u >= 0 && p == -1; u--) {
+        p = task->last[u];
+    }
+    for (value w = begin; w < end; w++) {
+        for (word W = task->bits[w]; W; W &= W - 1) {
+            value s = w * WORD_SIZE + __builtin_ctzll(W);
+            task->visit(task->S, p, s);
+            p = s;
+        }
+    }
+}
+
+void build_intervals(value n, const word *bits, void (*visit)(void *, value, value), void *S) {
+    // Call visit(S, p, s) in parallel for all consecutive elements p < s
+    // in the set, and for p = -1 and s = 0, where bits 0 and n + 1 must be set
+    // and no larger bits
+    value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    int threads = parallel_threads(n_words);
+    intervals_task task = {bits, visit, S};
+    parallel_for(threads, n_words, intervals_last, &task);
+    parallel_for(threads, n_words, intervals_visit, &task);
+}
+
+// ================================================================
+//   Successor-delete data structure from pseudocodes in the paper
+// ================================================================
+
+void *allocate(value max_n) {
+    // Create successor-delete array, the handle is the array A itself
+    return memory_malloc((max_n + 2) * sizeof(value));
+}
+
+void init(void *S, value n) {
+    value *A = S;
+    for (value i = 0; i < n + 2; i++) {
+        A[i] = i;
+    }
+}
+
+void delete(void *S, value i) {
+    value *A = S;
+    A[i] = i + 1;
+}
+
+void delete_checked(void *S, value i) {
+    value *A = S;
+    if (A[i] == i) {
+        A[i] = i + 1;
+    }
+}
+
+value successor_naive(void *S, value i) {
+    // no path compression
+    value *A = S;
+    while (i < A[i]) { 
+        i = A[i];
+        if (COUNTS) count_links++;
+    }
+    return i;
+}
+
+value successor_recursive(void *S, value i) {
+    // recursive path compression, where the recursion
+    //     if (i < A[i]) A[i] = successor_recursive(A, A[i]); return A[i];
+    // is replaced by pointer reversal, i.e., the first pass makes the nodes 
+    // after i point back along the path, and the second pass returns along 
+    // the reversed pointers, setting the nodes to the root in the same 
+    // order as the recursion returns, i.e., i is set last
+    value *A = S;
+    value prev = i, r = A[i];
+    if (COUNTS) count_links += i < r;
+    while (r < A[r]) {
+        value next = A[r];
+        A[r] = prev;
+        if (COUNTS) count_links++, count_write(&A[r]);
+        prev = r;
+        r = next;
+    }
+    while (prev != i) {
+        value back = A[prev];
+        A[prev] = r;
+        if (COUNTS) count_write(&A[prev]);
+        prev = back;
+    }
+    A[i] = r;
+    if (COUNTS) count_write(&A[i]);
+    return r;
+}
+
+value successor_2pass(void *S, value i) {
+    // 2-pass path compression
+    value *A = S;
+    value r = i;
+    while (r < A[r]) {
+        r = A[r];
+        if (COUNTS) count_links++;
+    }
+    while (A[i] < r) {
+        value i_next = A[i];
+        A[i] = r;
+        if (COUNTS) count_write(&A[i]);
+        i = i_next;
+    }
+    return r;
+}
+
+value successor_halving(void *S, value i) {
+    // path halving (1-pass)
+    value *A = S;
+    while (i < A[i]) {
+        if (COUNTS) count_links++, count_write(&A[i]);
+        i = A[i] = A[A[i]];
+    }
+    return i;
+}
+
+void delete_batch(void *S, const value *q, size_t k) {
+    value *A = S;
+    for (size_t j = 0; j < k; j++) {
+        A[q[j]] = q[j] + 1;
+    }
+}
+
+void delete_checked_batch(void *S, const value *q, size_t k) {
+    value *A = S;
+    for (size_t j = 0; j < k; j++) {
+        value i = q[j];
+        if (A[i] == i) {
+            A[i] = i + 1;
+        }
+    }
+}
+
+void delete_range(void *S, value l, value r) {
+    // All of [l, r] point directly to r + 1, which is at most their successor
+    value *A = S;
+    for (value i = l; i <= r; i++) {
+        A[i] = r + 1;
+    }
+}
+
+void delete_checked_range(void *S, value l, value r) {
+    // As delete_range, but never decreases a pointer
+    value *A = S;
+    for (value i = l; i <= r; i++) {
+        A[i] = A[i] > r + 1 ? A[i] : r + 1;
+    }
+}
+
+void successor_2pass_batch(void *S, const value *q, value *out, size_t k) {
+    // 2-pass path compression for BATCH_WIDTH queries at a time, where the 
+    // first passes are interleaved and prefetch the next node on each path
+    value *A = S;
+    for (size_t b = 0; b < k; b += BATCH_WIDTH) {
+        size_t w = k - b < BATCH_WIDTH ? k - b : BATCH_WIDTH;
+        value r[BATCH_WIDTH];
+        for (size_t j = 0; j < w; j++) {
+            r[j] = q[b + j];
+            __builtin_prefetch(&A[r[j]]);
+        }
+        for (int active = 1; active; ) {
+            active = 0;
+            for (size_t j = 0; j < w; j++) {
+                value next = A[r[j]];
+                if (r[j] < next) {
+                    r[j] = next;
+                    __builtin_prefetch(&A[next]);
+                    active = 1;
+                }
+            }
+        }
+        for (size_t j = 0; j < w; j++) {
+            value i = q[b + j];
+            while (A[i] < r[j]) {
+                value i_next = A[i];
+                A[i] = r[j];
+                i = i_next;
+            }
+            out[b + j] = r[j];
+        }
+    }
+}
+
+void successor_halving_batch(void *S, const value *q, value *out, size_t k) {
+    // path halving for BATCH_WIDTH interleaved queries at a time, where each
+    // step i = A[i] = A[A[i]] is split into two steps, reading A[i] and 
+    // A[A[i]] respectively, and each read is prefetched one round ahead
+    value *A = S;
+    for (size_t b = 0; b < k; b += BATCH_WIDTH) {
+        size_t w = k - b < BATCH_WIDTH ? k - b : BATCH_WIDTH;
+        value i[BATCH_WIDTH], next[BATCH_WIDTH];  // next[j] = A[i[j]], or -1 if not read
+        for (size_t j = 0; j < w; j++) {
+            i[j] = q[b + j];
+            next[j] = -1;
+            __builtin_prefetch(&A[i[j]]);
+        }
+        for (size_t active = w; active; ) {
+            active = 0;
+            for (size_t j = 0; j < w; j++) {
+                if (next[j] == -1) {
+                    next[j] = A[i[j]];
+                    if (i[j] < next[j]) {
+                        __builtin_prefetch(&A[next[j]]);
+                        active++;
+                    }
+                } else if (i[j] < next[j]) {
+                    i[j] = A[i[j]] = A[next[j]];
+                    next[j] = -1;
+                    __builtin_prefetch(&A[i[j]]);
+                    active++;
+                }
+            }
+        }
+        for (size_t j = 0; j < w; j++) {
+            out[b + j] = i[j];
+        }
+    }
+}
+
+int successor_2pass_step(void *S, successor_state *s) {
+    // One node of the first pass of successor_2pass, where the second pass
+    // is done in the last step, since the first pass cached its nodes
+    value *A = S;
+    if (s->i == -1) {
+        s->i = s->q;
+        __builtin_prefetch(&A[s->i]);
+        return 0;
+    }
+    value next = A[s->i];
+    if (s->i < next) {
+        s->i = next;
+        __builtin_prefetch(&A[next]);
+        return 0;
+    }
+    for (value i = s->q; A[i] < s->i; ) {
+        value i_next = A[i];
+        A[i] = s->i;
+        i = i_next;
+    }
+    return 1;
+}
+
+int successor_halving_step(void *S, successor_state *s) {
+    // One of the two reads A[i] and A[A[i]] of path halving, as in 
+    // successor_halving_batch, where next = A[i], or -1 if not read
+    value *A = S;
+    if (s->i == -1) {
+        s->i = s->q;
+    } else if (s->next == -1) {
+        s->next = A[s->i];
+        if (s->i == s->next) {
+            return 1;
+        }
+        __builtin_prefetch(&A[s->next]);
+        return 0;
+    } else {
+        s->i = A[s->i] = A[s->next];
+        s->next = -1;
+    }
+    __builtin_prefetch(&A[s->i]);
+    return 0;
+}
+
+void build_interval(void *S, value p, value s) {
+    value *A = S;
+    for (value i = p + 1; i <= s; i++) {
+        A[i] = s;
+    }
+}
+
+void build(void *S, value n, const word *bits) {
+    // Construct A with all paths compressed, i.e., A[i] = successor(i)
+    build_intervals(n, bits, build_interval, S);
+}
+
+const Algorithm alg_naive = {"successor, no compression", allocate, memory_free, init, delete, successor_naive, .build = build, .delete_range = delete_range};
+const Algorithm alg_recursive = {"successor, recursive", allocate, memory_free, init, delete, successor_recursive, .build = build, .delete_range = delete_range};
+const Algorithm alg_2pass = {"successor, 2-pass", allocate, memory_free, init, delete, successor_2pass, .successor_batch = successor_2pass_batch, .delete_batch = delete_batch, .build = build, .delete_range = delete_range, .successor_step = successor_2pass_step};
+const Algorithm alg_2pass_checked = {"successor, 2-pass, checked", allocate, memory_free, init, delete_checked, successor_2pass, .successor_batch = successor_2pass_batch, .delete_batch = delete_checked_batch, .build = build, .delete_range = delete_checked_range, .successor_step = successor_2pass_step};
+const Algorithm alg_halving = {"successor, halving", allocate, memory_free, init, delete, successor_halving, .successor_batch = successor_halving_batch, .delete_batch = delete_batch, .build = build, .delete_range = delete_range, .successor_step = successor_halving_step};
+
+// ================================================================
+//   Compression policies for the successor-delete array, trading the
+//   pointers (and cache lines) written by a query against how short 
+//   later paths become. The second pass of successor_2pass already only
+//   writes pointers that change, since it stops at the first A[i] == r, 
+//   whereas path halving rewrites the pointer to the root in its last step
+// ================================================================
+
+#define COMPRESS_BOUND 4  // nodes compressed by successor_2pass_bounded
+#define COMPRESS_EVERY 8  // queries per compressing query of alg_2pass_sampled
+
+value successor_halving_checked(void *S, value i) {
+    // path halving, only writing A[i] if A[A[i]] != A[i]
+    value *A = S;
+    while (i < A[i]) {
+        value next = A[i], next_next = A[next];
+        if (COUNTS) count_links++;
+        if (next < next_next) {
+            A[i] = next_next;
+            if (COUNTS) count_write(&A[i]);
+        }
+        i = next_next;
+    }
+    return i;
+}
+
+value successor_2pass_bounded(void *S, value i) {
+    // 2-pass path compression of only the first COMPRESS_BOUND nodes on 
+    // the path, bounding the writes of a query
+    value *A = S;
+    value r = i;
+    while (r < A[r]) {
+        r = A[r];
+        if (COUNTS) count_links++;
+    }
+    for (int k = 0; k < COMPRESS_BOUND && A[i] < r; k++) {
+        value i_next = A[i];
+        A[i] = r;
+        if (COUNTS) count_write(&A[i]);
+        i = i_next;
+    }
+    return r;
+}
+
+typedef struct {
+    value *A;          // successor-delete array
+    value countdown;   // queries until the next compressing query
+} sampled_set;
+
+void *sampled_allocate(value max_n) {
+    sampled_set *P = memory_malloc(sizeof(sampled_set));
+    P->A = allocate(max_n);
+    return P;
+}
+
+void sampled_free(void *S) {
+    sampled_set *P = S;
+    memory_free(P->A);
+    memory_free(P);
+}
+
+void sampled_init(void *S, value n) {
+    sampled_set *P = S;
+    init(P->A, n);
+    P->countdown = COMPRESS_EVERY;
+}
+
+void sampled_delete(void *S, value i) {
+    sampled_set *P = S;
+    delete(P->A, i);
+}
+
+value sampled_successor(void *S, value i) {
+    // 2-pass path compression on every COMPRESS_EVERY-th query, the 
+    // other queries only follow the path
+    sampled_set *P = S;
+    if (--P->countdown == 0) {
+        P->countdown = COMPRESS_EVERY;
+        return successor_2pass(P->A, i);
+    }
+    return successor_naive(P->A, i);
+}
+
+void sampled_build(void *S, value n, const word *bits) {
+    sampled_set *P = S;
+    build(P->A, n, bits);
+}
+
+void sampled_delete_range(void *S, value l, value r) {
+    sampled_set *P = S;
+    delete_range(P->A, l, r);
+}
+
+const Algorithm alg_halving_checked = {"successor, halving, checked", allocate, memory_free, init, delete, successor_halving_checked, .build = build, .delete_range = delete_range};
+const Algorithm alg_2pass_bounded = {"successor, 2-pass, bounded 4", allocate, memory_free, init, delete, successor_2pass_bounded, .build = build, .delete_range = delete_range};
+const Algorithm alg_2pass_sampled = {"successor, 2-pass, every 8th", sampled_allocate, sampled_free, sampled_init, sampled_delete, sampled_successor, .build = sampled_build, .delete_range = sampled_delete_range};
+
+// ================================================================
+//   Successor-predecessor-delete data structure from the paper, where 
+//   A[i] = predecessor(i - 1) < i for non-deleted i > 0
+// ================================================================
+
+void init_pred(void *S, value n) {
+    value *A = S;
+    A[0] = 0;
+    for (value i = 1; i < n + 2; i++) {
+        A[i] = i - 1;
+    }
+}
+
+value successor_pred_2pass(void *S, value i) {
+    // 2-pass path compression
+    value *A = S;
+    value r = i;
+    while (r < A[r]) {
+        r = A[r];
+        if (COUNTS) count_links++;
+    }
+    while (i < A[i]) {
+        value i_next = A[i];
+        A[i] = r;
+        if (COUNTS) count_write(&A[i]);
+        i = i_next;
+    }
+    return r;
+}
+
+void delete_pred(void *S, value i) {
+    value *A = S;
+    if (A[i] <= i) {
+        value j = successor_pred_2pass(A, i + 1);
+        A[j] = A[i];
+        A[i] = j;
+    }
+}
+
+value predecessor_pred(void *S, value i) {
+    value *A = S;
+    if (A[i] <= i) {
+        return i;
+    }
+    return A[successor_pred_2pass(A, i)];
+}
+
+void build_pred_interval(void *S, value p, value s) {
+    value *A = S;
+    for (value i = p + 1; i < s; i++) {
+        A[i] = s;
+    }
+    A[s] = p < 0 ? 0 : p;
+}
+
+void build_pred(void *S, value n, const word *bits) {
+    build_intervals(n, bits, build_pred_interval, S);
+}
+
+const Algorithm alg_2pass_pred = {"successor, 2-pass, predecessor", allocate, memory_free, init_pred, delete_pred, successor_pred_2pass, .predecessor = predecessor_pred, .build = build_pred};
+
+// ================================================================
+//   Lock-free concurrent successor-delete data structure, where all
+//   updates to A only increase A[i] for deleted i (i < A[i])
+// ================================================================
+
+typedef _Atomic value atomic_value;
+
+void *allocate_concurrent(value max_n) {
+    return memory_malloc((max_n + 2) * sizeof(atomic_value));
+}
+
+void init_concurrent(void *S, value n) {
+    atomic_value *A = S;
+    for (value i = 0; i < n + 2; i++) {
+        atomic_init(&A[i], i);
+    }
+}
+
+void delete_concurrent(void *S, value i) {
+    atomic_value *A = S;
+    if (atomic_load_explicit(&A[i], memory_order_relaxed) == i) {
+        atomic_store_explicit(&A[i], i + 1, memory_order_release);
+    }
+}
+
+value successor_2pass_concurrent(void *S, value i) {
+    // 2-pass path compression, where a compression fails if another thread 
+    // has already changed the pointer
+    atomic_value *A = S;
+    value r = i, next;
+    while (r < (next = atomic_load_explicit(&A[r], memory_order_acquire))) {
+        r = next;
+        if (COUNTS) count_links++;
+    }
+    while ((next = atomic_load_explicit(&A[i], memory_order_relaxed)) < r) {
+        atomic_compare_exchange_weak_explicit(&A[i], &next, r, memory_order_relaxed, memory_order_relaxed);
+        if (COUNTS) count_write(&A[i]);
+        i = next;
+    }
+    return r;
+}
+
+value successor_halving_concurrent(void *S, value i) {
+    // path halving (1-pass), where a compression fails if another thread 
+    // has already changed the pointer
+    atomic_value *A = S;
+    value next;
+    while (i < (next = atomic_load_explicit(&A[i], memory_order_acquire))) {
+        value next_next = atomic_load_explicit(&A[next], memory_order_acquire);
+        if (next < next_next) {
+            atomic_compare_exchange_weak_explicit(&A[i], &next, next_next, memory_order_relaxed, memory_order_relaxed);
+            if (COUNTS) count_write(&A[i]);
+        }
+        i = next_next;
+        if (COUNTS) count_links++;
+    }
+    return i;
+}
+
+void build_concurrent_interval(void *S, value p, value s) {
+    atomic_value *A = S;
+    for (value i = p + 1; i <= s; i++) {
+        atomic_init(&A[i], s);
+    }
+}
+
+void build_concurrent(void *S, value n, const word *bits) {
+    build_intervals(n, bits, build_concurrent_interval, S);
+}
+
+const Algorithm alg_2pass_concurrent = {"successor, 2-pass, concurrent", allocate_concurrent, memory_free, init_concurrent, delete_concurrent, successor_2pass_concurrent, .concurrent = 1, .build = build_concurrent};
+const Algorithm alg_halving_concurrent = {"successor, halving, concurrent", allocate_concurrent, memory_free, init_concurrent, delete_concurrent, successor_halving_concurrent, .concurrent = 1, .build = build_concurrent};
+
+// ================================================================
+//  Weighted quick-find union-find data structure (McIlroy and Morris)
+// ================================================================
+
+typedef struct { value root, weight, succ; } QF_node;
+
+void *QF_allocate(value max_n) {
+    return memory_malloc((max_n + 3) * sizeof(QF_node));  // + sentinel QF[n+2]
+}
+
+void QF_init(void *S, value n) {
+    QF_node *QF = S;
+    for (value i = 0; i < n + 2; i++) {
+        QF[i].root = i;
+        QF[i].weight = 1;
+        QF[i].succ = i;
+    }
+    QF[n + 2].root = -1;  // sentinel stopping relabeling in QF_delete
+}
+
+value QF_successor(void *S, value i) {
+    QF_node *QF = S;
+    if (COUNTS) count_links += QF[i].root != i;
+    return QF[QF[i].root].succ;
+}
+
+void QF_delete(void *S, value i) {
+    QF_node *QF = S;
+    if (QF[QF[i].root].succ == i) {  // i == succ(i), i.e., i is not deleted
+        value r1 = QF[i].root, r2 = QF[i+1].root;
+        if (QF[r1].weight <= QF[r2].weight) {
+            QF[r2].weight += QF[r1].weight;
+            for (value r=i; QF[r].root == r1; r--) QF[r].root = r2;
+        } else {
+            QF[r1].succ = QF[r2].succ;
+            QF[r1].weight += QF[r2].weight;
+            for (value r=i+1; QF[r].root == r2; r++) QF[r].root = r1;
+        }
+    }
+}   
+
+void QF_build_interval(void *S, value p, value s) {
+    // The set (p, s] has root s 
+    QF_node *QF = S;
+    for (value i = p + 1; i <= s; i++) {
+        QF[i].root = s;
+        QF[i].weight = 1;
+        QF[i].succ = i;
+    }
+    QF[s].weight = s - p;
+}
+
+void QF_build(void *S, value n, const word *bits) {
+    QF_node *QF = S;
+    build_intervals(n, bits, QF_build_interval, QF);
+    QF[n + 2].root = -1;  // sentinel stopping relabeling in QF_delete
+}
+
+const Algorithm alg_quick_find = {"quick find", QF_allocate, memory_free, QF_init, QF_delete, QF_successor, .build = QF_build};
+
+// ================================================================
+//  Union-find data structure with union by weight and 2-pass path compression
+// ================================================================
+
+typedef struct { value parent, weight, succ; } UF_node;
+
+void *UF_allocate(value max_n) {
+    return memory_malloc((max_n + 2) * sizeof(UF_node));
+}
+
+void UF_init(void *S, value n) {
+    UF_node *UF = S;
+    for (value i = 0; i < n + 2; i++) {
+        UF[i].parent = i;
+        UF[i].weight = 1;
+        UF[i].succ = i;
+    }
+}
+
+value UF_find(UF_node *UF, value i) {
+    value r = i;
+    while (UF[r].parent != r) {
+        r = UF[r].parent;
+        if (COUNTS) count_links++;
+    }
+    while (i != r) {
+        value p = UF[i].parent;
+        UF[i].parent = r;
+        if (COUNTS) count_write(&UF[i].parent);
+        i = p;
+    }   
+    return r;
+}
+
+int UF_successor_step(void *S, successor_state *s) {
+    // One node of the first pass of UF_find, where the compression and the
+    // answer are done in the last step
+    UF_node *UF = S;
+    if (s->i == -1) {
+        s->i = s->q;
+        __builtin_prefetch(&UF[s->i]);
+        return 0;
+    }
+    value r = UF[s->i].parent;
+    if (r != s->i) {
+        s->i = r;
+        __builtin_prefetch(&UF[r]);
+        return 0;
+    }
+    for (value i = s->q; i != r; ) {
+        value p = UF[i].parent;
+        UF[i].parent = r;
+        i = p;
+    }
+    s->i = UF[r].succ;
+    return 1;
+}
+
+value UF_union(UF_node *UF, value i, value j) {
+    // Union the sets containing i and j, and return the new root
+    value r1 = UF_find(UF, i);
+    value r2 = UF_find(UF, j);
+    if (r1 == r2) {
+        return r1;
+    }
+    if (UF[r1].weight <= UF[r2].weight) {
+        UF[r2].weight += UF[r1].weight;
+        UF[r1].parent = r2;
+        return r2;
+    } else {
+        UF[r1].weight += UF[r2].weight;
+        UF[r2].parent = r1;
+        UF[r1].succ = UF[r2].succ;
+        return r1;
+    }    
+}
+
+value UF_successor(void *S, value i) {
+    UF_node *UF = S;
+    return UF[UF_find(UF, i)].succ;
+}
+
+void UF_delete(void *S, value i) {
+    UF_union(S, i, i + 1);
+}   
+
+void UF_build_interval(void *S, value p, value s) {
+    // The set (p, s] has root s, and all paths have length at most one
+    UF_node *UF = S;
+    for (value i = p + 1; i <= s; i++) {
+        UF[i].parent = s;
+        UF[i].weight = 1;
+        UF[i].succ = i;
+    }
+    UF[s].weight = s - p;
+}
+
+void UF_build(void *S, value n, const word *bits) {
+    build_intervals(n, bits, UF_build_interval, S);
+}
+
+const Algorithm alg_union_find = {"union find", UF_allocate, memory_free, UF_init, UF_delete, UF_successor, .build = UF_build, .successor_step = UF_successor_step};
+
+// Union-find with predecessors, where pred[r] for a root r is the predecessor
+// of min of the set, i.e., the set of r is the interval (pred[r], UF[r].succ]
+
+typedef struct {
+    UF_node *UF;
+    value *pred;
+} UF_pred_set;
+
+void *UF_pred_allocate(value max_n) {
+    UF_pred_set *U = memory_malloc(sizeof(UF_pred_set));
+    U->UF = UF_allocate(max_n);
+    U->pred = memory_malloc((max_n + 2) * sizeof(value));
+    return U;
+}
+
+void UF_pred_free(void *S) {
+    UF_pred_set *U = S;
+    memory_free(U->UF);
+    memory_free(U->pred);
+    memory_free(U);
+}
+
+void UF_pred_init(void *S, value n) {
+    UF_pred_set *U = S;
+    UF_init(U->UF, n);
+    for (value i = 0; i < n + 2; i++) {
+        U->pred[i] = i - 1;
+    }
+}
+
+value UF_pred_successor(void *S, value i) {
+    UF_pred_set *U = S;
+    return UF_successor(U->UF, i);
+}
+
+void UF_pred_delete(void *S, value i) {
+    UF_pred_set *U = S;
+    value p = U->pred[UF_find(U->UF, i)];
+    U->pred[UF_union(U->UF, i, i + 1)] = p;
+}
+
+value UF_pred_predecessor(void *S, value i) {
+    UF_pred_set *U = S;
+    value r = UF_find(U->UF, i);
+    return U->UF[r].succ == i ? i : U->pred[r];
+}
+
+void UF_pred_build_interval(void *S, value p, value s) {
+    UF_pred_set *U = S;
+    UF_build_interval(U->UF, p, s);
+    U->pred[s] = p;
+}
+
+void UF_pred_build(void *S, value n, const word *bits) {
+    build_intervals(n, bits, UF_pred_build_interval, S);
+}
+
+const Algorithm alg_union_find_pred = {"union find, predecessor", UF_pred_allocate, UF_pred_free, UF_pred_init, UF_pred_delete, UF_pred_successor, .predecessor = UF_pred_predecessor, .build = UF_pred_build};
+
+// ================================================================
+//  Compact union-find and quick-find with one value per element, where 
+//  C[i] is the parent (or label) of a non-root i, and the slot of a root r
+//  is compact_root(succ, rank) < 0, i.e., only roots store the successor 
+//  and a rank in COMPACT_RANK_BITS bits, and sets are united by rank
+// ================================================================
+
+#define COMPACT_RANK_BITS 6  // rank < 64 in a root slot
+#define COMPACT_MAX_N (((value) 1 << (8 * sizeof(value) - 1 - COMPACT_RANK_BITS)) - 2)  // successors fit in root slots
+
+value compact_root(value succ, value rank) {
+    return -1 - (succ << COMPACT_RANK_BITS | rank);
+}
+
+value compact_succ(value slot) {
+    return (-1 - slot) >> COMPACT_RANK_BITS;
+}
+
+value compact_rank(value slot) {
+    return (-1 - slot) & ((1 << COMPACT_RANK_BITS) - 1);
+}
+
+value compact_interval_rank(value p, value s) {
+    // floor(log2(s - p)) for the set (p, s] in bulk construction
+    return 63 - __builtin_clzll(s - p);
+}
+
+void *CUF_allocate(value max_n) {
+    assert(max_n <= COMPACT_MAX_N);
+    return memory_malloc((max_n + 2) * sizeof(value));
+}
+
+void CUF_init(void *S, value n) {
+    value *C = S;
+    for (value i = 0; i < n + 2; i++) {
+        C[i] = compact_root(i, 0);
+    }
+}
+
+value CUF_find(value *C, value i) {
+    // 2-pass path compression
+    value r = i;
+    while (C[r] >= 0) {
+        r = C[r];
+        if (COUNTS) count_links++;
+    }
+    while (i != r) {
+        value p = C[i];
+        C[i] = r;
+        if (COUNTS) count_write(&C[i]);
+        i = p;
+    }
+    return r;
+}
+
+value CUF_successor(void *S, value i) {
+    value *C = S;
+    return compact_succ(C[CUF_find(C, i)]);
+}
+
+void CUF_delete(void *S, value i) {
+    // Union the sets of i and i + 1, where the set of i + 1 has the successor
+    value *C = S;
+    value r1 = CUF_find(C, i), r2 = CUF_find(C, i + 1);
+    if (r1 == r2) {
+        return;
+    }
+    value succ = compact_succ(C[r2]), k1 = compact_rank(C[r1]), k2 = compact_rank(C[r2]);
+    if (k1 < k2) {
+        C[r1] = r2;
+    } else {
+        C[r2] = r1;
+        C[r1] = compact_root(succ, k1 + (k1 == k2));
+    }
+}
+
+void CUF_build_interval(void *S, value p, value s) {
+    // The set (p, s] is a star with root s
+    value *C = S;
+    for (value i = p + 1; i < s; i++) {
+        C[i] = s;
+    }
+    C[s] = compact_root(s, compact_interval_rank(p, s));
+}
+
+void CUF_build(void *S, value n, const word *bits) {
+    build_intervals(n, bits, CUF_build_interval, S);
+}
+
+const Algorithm alg_union_find_compact = {"union find, compact", CUF_allocate, memory_free, CUF_init, CUF_delete, CUF_successor, .build = CUF_build, .max_n = COMPACT_MAX_N};
+
+// Quick-find, where all elements of a set have the root as label, and the
+// root r is always in its own set, so its slot can store the successor 
+
+void *CQF_allocate(value max_n) {
+    assert(max_n <= COMPACT_MAX_N);
+    return memory_malloc((max_n + 3) * sizeof(value));  // + sentinel Q[n+2]
+}
+
+void CQF_init(void *S, value n) {
+    value *Q = S;
+    for (value i = 0; i < n + 2; i++) {
+        Q[i] = compact_root(i, 0);
+    }
+    Q[n + 2] = n + 2;  // sentinel stopping relabeling in CQF_delete
+}
+
+value CQF_label(const value *Q, value i) {
+    return Q[i] < 0 ? i : Q[i];
+}
+
+value CQF_successor(void *S, value i) {
+    value *Q = S;
+    if (COUNTS) count_links += CQF_label(Q, i) != i;
+    return compact_succ(Q[CQF_label(Q, i)]);
+}
+
+void CQF_delete(void *S, value i) {
+    // Relabel the set of smaller rank, scanning from i down or from i + 1 up
+    value *Q = S;
+    value r1 = CQF_label(Q, i), r2 = CQF_label(Q, i + 1);
+    if (compact_succ(Q[r1]) == i) {  // i is not deleted
+        value succ = compact_succ(Q[r2]), k1 = compact_rank(Q[r1]), k2 = compact_rank(Q[r2]);
+        if (k1 <= k2) {
+            for (value r = i; CQF_label(Q, r) == r1; r--) Q[r] = r2;
+            Q[r2] = compact_root(succ, k2 + (k1 == k2));
+        } else {
+            for (value r = i + 1; CQF_label(Q, r) == r2; r++) Q[r] = r1;
+            Q[r1] = compact_root(succ, k1);
+        }
+    }
+}
+
+void CQF_build(void *S, value n, const word *bits) {
+    // The sets are stars as for union-find, i.e., labelled by their root
+    value *Q = S;
+    build_intervals(n, bits, CUF_build_interval, Q);
+    Q[n + 2] = n + 2;  // sentinel stopping relabeling in CQF_delete
+}
+
+const Algorithm alg_quick_find_compact = {"quick find, compact", CQF_allocate, memory_free, CQF_init, CQF_delete, CQF_successor, .build = CQF_build, .max_n = COMPACT_MAX_N};
+
+// ================================================================
+//  Generic successor-delete structure with mircosets
+// ================================================================
+
+typedef struct {
+    word *microsets;                // array of microsets
+    const Algorithm *alg_macroset;  // algorithm to use for macroset structure
+    void *macroset;                 // macroset structure
+    value n;                        // set is a subset of {0, ..., n + 1}
+} microset_set;
+
+void *microset_allocate(const Algorithm *alg_macroset, value max_n) {
+    value n_buckets = (max_n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    microset_set *M = memory_malloc(sizeof(microset_set));
+    M->microsets = memory_malloc(n_buckets * sizeof(word));  
+    M->alg_macroset = alg_macroset;
+    M->macroset = alg_macroset->create(n_buckets);
+    return M;
+}
+
+void microset_free(void *S) {
+    microset_set *M = S;
+    M->alg_macroset->destroy(M->macroset);
+    memory_free(M->microsets);
+    memory_free(M);
+}
+
+void microset_init(void *S, value n) {
+    microset_set *M = S;
+    value n_buckets = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    M->n = n;
+    M->alg_macroset->init(M->macroset, n_buckets);
+    for (value i = 0; i < n_buckets; i++) {
+        M->microsets[i] = (word) -1;  // all ones
+    }
+}
+
+void microset_delete(void *S, value i) {
+    microset_set *M = S;
+    value bucket = i / WORD_SIZE;
+    value bit = i % WORD_SIZE;
+    word mask = (word) 1 << bit;
+    if (M->microsets[bucket] & mask) {
+        M->microsets[bucket] ^= mask;
+        if (M->microsets[bucket] == 0) {
+            M->alg_macroset->delete(M->macroset, bucket);
+        }
+    }
+}
+
+value microset_successor(void *S, value i) {
+    microset_set *M = S;
+    value bucket = i / WORD_SIZE;
+    value bit = i % WORD_SIZE;
+    word mask = (word) 1 << bit;
+
+    word W = M->microsets[bucket];
+    word high_bits = W & ~(((word)1 << bit) - 1);
+    if (high_bits) {
+        return bucket * WORD_SIZE + __builtin_ctzll(high_bits);
+    } else {
+        value succ_bucket = M->alg_macroset->successor(M->macroset, bucket + 1);
+        return succ_bucket * WORD_SIZE + __builtin_ctzll(M->microsets[succ_bucket]);
+    }
+}
+
+void words_clear_range(word *words, value l, value r, value *first, value *last) {
+    // Clear the bits [l, r] of words with masks on the first and last word, 
+    // and set [first, last] to the words that are now zero, i.e., 
+    // words l / WORD_SIZE + 1, ..., r / WORD_SIZE - 1 and possibly the end words
+    value bl = l / WORD_SIZE, br = r / WORD_SIZE;
+    word low = (word) -1 << (l % WORD_SIZE);         // bits from l in word bl
+    word high = ((word) 2 << (r % WORD_SIZE)) - 1;   // bits up to r in word br
+    if (bl == br) {
+        words[bl] &= ~(low & high);
+    } else {
+        words[bl] &= ~low;
+        for (value b = bl + 1; b < br; b++) {
+            words[b] = 0;
+        }
+        words[br] &= ~high;
+    }
+    *first = words[bl] == 0 ? bl : bl + 1;
+    *last = words[br] == 0 ? br : br - 1;
+}
+
+void microset_delete_range(void *S, value l, value r) {
+    // Clear whole words, and delete the buckets that are now empty by a single 
+    // range delete in the macroset, where deleting an empty bucket again is allowed
+    microset_set *M = S;
+    value first, last;
+    words_clear_range(M->microsets, l, r, &first, &last);
+    if (first <= last) {
+        batch_delete_range(M->alg_macroset, M->macroset, first, last);
+    }
+}
+
+void microset_delete_batch(void *S, const value *q, size_t k) {
+    microset_set *M = S;
+    for (size_t j = 0; j < k; j++) {
+        __builtin_prefetch(&M->microsets[q[j] / WORD_SIZE]);
+    }
+    for (size_t j = 0; j < k; j++) {
+        microset_delete(M, q[j]);
+    }
+}
+
+void microset_successor_batch(void *S, const value *q, value *out, size_t k) {
+    // Answer queries inside the microsets first, and all remaining queries
+    // by a single batch of successor queries to the macroset
+    microset_set *M = S;
+    value buckets[BATCH_SIZE], succ_buckets[BATCH_SIZE];
+    size_t misses[BATCH_SIZE];
+    for (size_t b = 0; b < k; b += BATCH_SIZE) {
+        size_t w = k - b < BATCH_SIZE ? k - b : BATCH_SIZE;
+        for (size_t j = 0; j < w; j++) {
+            __builtin_prefetch(&M->microsets[q[b + j] / WORD_SIZE]);
+        }
+        size_t m = 0;
+        for (size_t j = 0; j < w; j++) {
+            value i = q[b + j];
+            value bucket = i / WORD_SIZE;
+            value bit = i % WORD_SIZE;
+            word high_bits = M->microsets[bucket] & ~(((word)1 << bit) - 1);
+            if (high_bits) {
+                out[b + j] = bucket * WORD_SIZE + __builtin_ctzll(high_bits);
+            } else {
+                buckets[m] = bucket + 1;
+                misses[m++] = b + j;
+            }
+        }
+        if (m > 0) {
+            batch_successor(M->alg_macroset, M->macroset, buckets, succ_buckets, m);
+            for (size_t j = 0; j < m; j++) {
+                __builtin_prefetch(&M->microsets[succ_buckets[j]]);
+            }
+            for (size_t j = 0; j < m; j++) {
+                value succ_bucket = succ_buckets[j];
+                out[misses[j]] = succ_bucket * WORD_SIZE + __builtin_ctzll(M->microsets[succ_bucket]);
+            }
+        }
+    }
+}
+
+// Scans for the first non-zero word in words[b, end), returning end if
+// none, with a scalar, an AVX2 and an AVX-512 kernel selected at runtime
+// by simd_dispatch
+
+value scan_words_scalar(const word *words, value b, value end) {
+    while (b < end && words[b] == 0) {
+        b++;
+    }
+    return b;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+value scan_words_avx2(const word *words, value b, value end) {
+    for (; b + 4 <= end; b += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) &words[b]);
+        int zero = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, _mm256_setzero_si256())));
+        if (zero != 15) {
+            return b + __builtin_ctz(~zero);
+        }
+    }
+    return scan_words_scalar(words, b, end);
+}
+
+__attribute__((target("avx512f")))
+value scan_words_avx512(const word *words, value b, value end) {
+    for (; b + 8 <= end; b += 8) {
+        __m512i v = _mm512_loadu_si512((const void *) &words[b]);
+        __mmask8 nonzero = _mm512_test_epi64_mask(v, v);
+        if (nonzero) {
+            return b + __builtin_ctz(nonzero);
+        }
+    }
+    return scan_words_scalar(words, b, end);
+}
+#endif
+
+value (*scan_words)(const word *, value, value) = scan_words_scalar;
+const char *scan_words_kernel = "scalar";
+
+void simd_dispatch() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        scan_words = scan_words_avx512;
+        scan_words_kernel = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        scan_words = scan_words_avx2;
+        scan_words_kernel = "avx2";
+    }
+#endif
+}
+
+#define MICROSET_SCAN 8  // words scanned before the macroset is used
+
+value microset_next_bucket(microset_set *M, value bucket) {
+    // First non-empty microset after bucket, which must be before the 
+    // microset containing n + 1
+    value last = (M->n + 1) / WORD_SIZE;
+    value end = bucket + 1 + MICROSET_SCAN < last + 1 ? bucket + 1 + MICROSET_SCAN : last + 1;
+    value b = scan_words(M->microsets, bucket + 1, end);
+    return b < end ? b : M->alg_macroset->successor(M->macroset, bucket + 1);
+}
+
+void microset_successor_range(void *S, value i, value *out, size_t k) {
+    // Report the bits of the words from i, where bits after n + 1 are ignored
+    microset_set *M = S;
+    value last = (M->n + 1) / WORD_SIZE;
+    word last_mask = ((word) 2 << ((M->n + 1) % WORD_SIZE)) - 1;  // bits up to n + 1
+    value bucket = i / WORD_SIZE;
+    word W = M->microsets[bucket] & ((word) -1 << (i % WORD_SIZE));
+    size_t j = 0;
+    while (1) {
+        if (bucket == last) {
+            W &= last_mask;
+        }
+        for (; W && j < k; W &= W - 1) {
+            out[j++] = bucket * WORD_SIZE + __builtin_ctzll(W);
+        }
+        if (j == k) {
+            return;
+        }
+        if (bucket == last) {
+            break;
+        }
+        bucket = microset_next_bucket(M, bucket);
+        W = M->microsets[bucket];
+    }
+    for (; j < k; j++) {
+        out[j] = M->n + 1;
+    }
+}
+
+void microset_successor_sorted(void *S, const value *q, value *out, size_t k) {
+    // A query not larger than the previous answer has the same answer, 
+    // otherwise the words after the query are scanned before the macroset
+    microset_set *M = S;
+    value answer = -1;
+    for (size_t j = 0; j < k; j++) {
+        if (q[j] > answer) {
+            value bucket = q[j] / WORD_SIZE;
+            word high_bits = M->microsets[bucket] & ((word) -1 << (q[j] % WORD_SIZE));
+            if (!high_bits) {
+                bucket = microset_next_bucket(M, bucket);
+                high_bits = M->microsets[bucket];
+            }
+            answer = bucket * WORD_SIZE + __builtin_ctzll(high_bits);
+        }
+        out[j] = answer;
+    }
+}
+
+value microset_predecessor(void *S, value i) {
+    microset_set *M = S;
+    value bucket = i / WORD_SIZE;
+    value bit = i % WORD_SIZE;
+
+    word low_bits = M->microsets[bucket] & (((word) 2 << bit) - 1);
+    if (low_bits) {
+        return bucket * WORD_SIZE + WORD_SIZE - 1 - __builtin_clzll(low_bits);
+    } else {
+        value pred_bucket = M->alg_macroset->predecessor(M->macroset, bucket - 1);
+        return pred_bucket * WORD_SIZE + WORD_SIZE - 1 - __builtin_clzll(M->microsets[pred_bucket]);
+    }
+}
+
+typedef struct {
+    const word *bits;
+    word *microsets;
+    word *buckets;  // bit b is set if and only if microsets[b] != 0
+} microset_build_task;
+
+void microset_build_words(void *arg, int t, value begin, value end) {
+    // Copy the words [begin, end) and set their bits in buckets, where
+    // begin and end are multiples of WORD_SIZE, except for the last end
+    microset_build_task *task = arg;
+    for (value b = begin; b < end; b++) {
+        task->microsets[b] = task->bits[b];
+    }
+    for (value w = begin / WORD_SIZE; w * WORD_SIZE < end; w++) {
+        word W = 0;
+        for (value b = w * WORD_SIZE; b < end && b < (w + 1) * WORD_SIZE; b++) {
+            W |= (word) (task->bits[b] != 0) << (b % WORD_SIZE);
+        }
+        task->buckets[w] = W;
+    }
+}
+
+void parallel_for_words(value n_words, void (*f)(void *, int, value, value), void *arg) {
+    // Call f in parallel for ranges of words whose boundaries are 
+    // multiples of WORD_SIZE words, i.e., ranges for whole words at the level above
+    value n_blocks = (n_words + WORD_SIZE - 1) / WORD_SIZE;
+    int threads = parallel_threads(n_words);
+    if (threads > n_blocks) threads = n_blocks;
+    value ends[MAX_THREADS + 1];
+    for (int t = 0; t <= threads; t++) {
+        ends[t] = n_blocks * t / threads * WORD_SIZE;
+    }
+    ends[threads] = n_words;
+    pthread_t thread[MAX_THREADS];
+    parallel_task task[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        task[t] = (parallel_task) {f, arg, t, ends[t], ends[t + 1]};
+        if (t > 0) {
+            pthread_create(&thread[t], NULL, parallel_run, &task[t]);
+        }
+    }
+    parallel_run(&task[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(thread[t], NULL);
+    }
+}
+
+void microset_build(void *S, value n, const word *bits) {
+    // Copy the microsets, and build the macroset from the non-empty microsets
+    microset_set *M = S;
+    value n_buckets = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    M->n = n;
+    word *buckets = calloc((n_buckets + 2 + WORD_SIZE - 1) / WORD_SIZE, sizeof(word));
+    microset_build_task task = {bits, M->microsets, buckets};
+    parallel_for_words(n_buckets, microset_build_words, &task);
+    // Buckets n_buckets and n_buckets + 1 are the end of the macroset
+    buckets[n_buckets / WORD_SIZE] |= (word) 1 << (n_buckets % WORD_SIZE);
+    buckets[(n_buckets + 1) / WORD_SIZE] |= (word) 1 << ((n_buckets + 1) % WORD_SIZE);
+    M->alg_macroset->build(M->macroset, n_buckets, buckets);
+    free(buckets);
+}
+
+void *QF_microset_allocate(value max_n) {
+    return microset_allocate(&alg_quick_find, max_n);
+}
+
+void *UF_microset_allocate(value max_n) {
+    return microset_allocate(&alg_union_find, max_n);
+}
+
+void *DS_microset_allocate(value max_n) {
+    return microset_allocate(&alg_2pass, max_n);
+}
+
+void *CQF_microset_allocate(value max_n) {
+    return microset_allocate(&alg_quick_find_compact, max_n);
+}
+
+void *CUF_microset_allocate(value max_n) {
+    return microset_allocate(&alg_union_find_compact, max_n);
+}
+
+void *UF_pred_microset_allocate(value max_n) {
+    return microset_allocate(&alg_union_find_pred, max_n);
+}
+
+void *DS_pred_microset_allocate(value max_n) {
+    return microset_allocate(&alg_2pass_pred, max_n);
+}
+
+// Statically composed microset engines, where MICROSET_ENGINE(E, ...)
+// defines E_delete, E_successor and E_replay with direct calls to the 
+// macroset operations, that the compiler can inline into the microset 
+// operations, instead of calls through M->alg_macroset; the remaining 
+// operations use the generic microset functions
+
+#define MICROSET_ENGINE(E, macro_delete, macro_successor)                       \
+void E##_delete(void *S, value i) {                                             \
+    microset_set *M = S;                                                        \
+    value bucket = i / WORD_SIZE;                                               \
+    word mask = (word) 1 << (i % WORD_SIZE);                                    \
+    if (M->microsets[bucket] & mask) {                                          \
+        M->microsets[bucket] ^= mask;                                           \
+        if (M->microsets[bucket] == 0) {                                        \
+            macro_delete(M->macroset, bucket);                                  \
+        }                                                                       \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+value E##_successor(void *S, value i) {                                         \
+    microset_set *M = S;                                                        \
+    value bucket = i / WORD_SIZE;                                               \
+    word high_bits = M->microsets[bucket] & ((word) -1 << (i % WORD_SIZE));     \
+    if (high_bits) {                                                            \
+        return bucket * WORD_SIZE + __builtin_ctzll(high_bits);                 \
+    }                                                                           \
+    value succ_bucket = macro_successor(M->macroset, bucket + 1);               \
+    return succ_bucket * WORD_SIZE + __builtin_ctzll(M->microsets[succ_bucket]);\
+}                                                                               \
+                                                                                \
+value E##_replay(void *S, const value *input) {                                 \
+    value answers = 0;                                                          \
+    for (; *input != 0; input++) {                                              \
+        if (*input >= 0) {                                                      \
+            answers ^= E##_successor(S, *input);                                \
+        } else {                                                                \
+            E##_delete(S, -*input);                                             \
+        }                                                                       \
+    }                                                                           \
+    return answers;                                                             \
+}
+
+MICROSET_ENGINE(QF_microset, QF_delete, QF_successor)                // Microset<QuickFind>
+MICROSET_ENGINE(UF_microset, UF_delete, UF_successor)                // Microset<UnionFind>
+MICROSET_ENGINE(DS_microset, delete, successor_2pass)                // Microset<TwoPass>
+MICROSET_ENGINE(UF_pred_microset, UF_pred_delete, UF_pred_successor) // Microset<UnionFindPred>
+MICROSET_ENGINE(DS_pred_microset, delete_pred, successor_pred_2pass) // Microset<TwoPassPred>
+MICROSET_ENGINE(DS_microset2, DS_microset_delete, DS_microset_successor)  // Microset<Microset<TwoPass>>
+MICROSET_ENGINE(CQF_microset, CQF_delete, CQF_successor)             // Microset<CompactQuickFind>
+MICROSET_ENGINE(CUF_microset, CUF_delete, CUF_successor)             // Microset<CompactUnionFind>
+
+const Algorithm alg_qf_microset = {"quick find, microset", QF_microset_allocate, microset_free, microset_init, QF_microset_delete, QF_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = QF_microset_replay};
+const Algorithm alg_uf_microset = {"union find, microset", UF_microset_allocate, microset_free, microset_init, UF_microset_delete, UF_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = UF_microset_replay};
+const Algorithm alg_ds_microset = {"successor, 2-pass, microset", DS_microset_allocate, microset_free, microset_init, DS_microset_delete, DS_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = DS_microset_replay};
+const Algorithm alg_uf_pred_microset = {"union find, microset, predecessor", UF_pred_microset_allocate, microset_free, microset_init, UF_pred_microset_delete, UF_pred_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .predecessor = microset_predecessor, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = UF_pred_microset_replay};
+const Algorithm alg_ds_pred_microset = {"successor, 2-pass, microset, predecessor", DS_pred_microset_allocate, microset_free, microset_init, DS_pred_microset_delete, DS_pred_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .predecessor = microset_predecessor, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = DS_pred_microset_replay};
+
+void *DS_microset2_allocate(value max_n) {
+    return microset_allocate(&alg_ds_microset, max_n);
+}
+
+const Algorithm alg_ds_microset2 = {"successor, 2-pass, microset of microsets", DS_microset2_allocate, microset_free, microset_init, DS_microset2_delete, DS_microset2_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = DS_microset2_replay};
+const Algorithm alg_cqf_microset = {"quick find, compact, microset", CQF_microset_allocate, microset_free, microset_init, CQF_microset_delete, CQF_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = CQF_microset_replay};
+const Algorithm alg_cuf_microset = {"union find, compact, microset", CUF_microset_allocate, microset_free, microset_init, CUF_microset_delete, CUF_microset_successor, .successor_batch = microset_successor_batch, .delete_batch = microset_delete_batch, .build = microset_build, .successor_range = microset_successor_range, .successor_sorted = microset_successor_sorted, .delete_range = microset_delete_range, .replay = CUF_microset_replay};
+
+// ================================================================
+//  Cache line blocked successor-delete structure, where the elements
+//  are partitioned into blocks of BLOCK elements, each stored in a cache
+//  line of BLOCK byte offsets with path compression inside the block,
+//  and a successor-delete array on the blocks, where a block is deleted
+//  when all its elements are deleted. The offset of a deleted element 
+//  is BLOCK if all later elements in its block are deleted.
+// ================================================================
+
+#define BLOCK 64  // elements in a block, offsets are bytes
+
+typedef struct {
+    unsigned char *local;   // local[i] = offset in block of i, cache line aligned
+    void *local_memory;     // allocation containing local
+    value *blocks;          // successor-delete array on the blocks
+} blocked_set;
+
+void *blocked_allocate(value max_n) {
+    value n_blocks = (max_n + 2 + BLOCK - 1) / BLOCK;
+    blocked_set *D = memory_malloc(sizeof(blocked_set));
+    D->local_memory = memory_malloc(n_blocks * BLOCK + 64);
+    D->local = (unsigned char *) (((size_t) D->local_memory + 63) / 64 * 64);
+    D->blocks = allocate(n_blocks);
+    return D;
+}
+
+void blocked_free(void *S) {
+    blocked_set *D = S;
+    memory_free(D->blocks);
+    memory_free(D->local_memory);
+    memory_free(D);
+}
+
+void blocked_init(void *S, value n) {
+    blocked_set *D = S;
+    value n_blocks = (n + 2 + BLOCK - 1) / BLOCK;
+    for (value i = 0; i < n_blocks * BLOCK; i++) {
+        D->local[i] = i % BLOCK;
+    }
+    init(D->blocks, n_blocks);
+}
+
+value block_successor(unsigned char *L, value i) {
+    // 2-pass path compression inside the block L, returns BLOCK if all 
+    // elements from offset i in the block are deleted
+    value r = i;
+    while (r < BLOCK && r < L[r]) {
+        r = L[r];
+        if (COUNTS) count_links++;
+    }
+    while (L[i] < r) {
+        value i_next = L[i];
+        L[i] = r;
+        if (COUNTS) count_write(&L[i]);
+        i = i_next;
+    }
+    return r;
+}
+
+void blocked_delete(void *S, value i) {
+    blocked_set *D = S;
+    value b = i / BLOCK, o = i % BLOCK;
+    unsigned char *L = D->local + b * BLOCK;
+    if (L[o] == o) {
+        L[o] = o + 1;
+        if (block_successor(L, 0) == BLOCK) {
+            delete(D->blocks, b);
+        }
+    }
+}
+
+void blocked_delete_range(void *S, value l, value r) {
+    // Elements in blocks before r's block point to the end of their block, 
+    // and elements in r's block to r + 1, and the empty blocks are deleted
+    // by a single range delete on the blocks
+    blocked_set *D = S;
+    value bl = l / BLOCK, br = r / BLOCK;
+    for (value i = l; i <= r; i++) {
+        D->local[i] = i / BLOCK < br ? BLOCK : r % BLOCK + 1;
+    }
+    value first = block_successor(D->local + bl * BLOCK, 0) == BLOCK ? bl : bl + 1;
+    value last = block_successor(D->local + br * BLOCK, 0) == BLOCK ? br : br - 1;
+    if (first <= last) {
+        delete_range(D->blocks, first, last);
+    }
+}
+
+value blocked_successor(void *S, value i) {
+    blocked_set *D = S;
+    value b = i / BLOCK;
+    value r = block_successor(D->local + b * BLOCK, i % BLOCK);
+    if (r < BLOCK) {
+        return b * BLOCK + r;
+    }
+    b = successor_2pass(D->blocks, b + 1);
+    return b * BLOCK + block_successor(D->local + b * BLOCK, 0);
+}
+
+void blocked_build_interval(void *S, value p, value s) {
+    // Blocks are whole words of the bitmap, so threads write disjoint blocks
+    blocked_set *D = S;
+    value block = s / BLOCK;
+    for (value i = p + 1; i < s; i++) {
+        D->local[i] = i / BLOCK == block ? s % BLOCK : BLOCK;
+    }
+    D->local[s] = s % BLOCK;
+    for (value b = (p + BLOCK) / BLOCK; b < block; b++) {  // blocks after p's block, or from 0 if p = -1
+        D->blocks[b] = block;
+    }
+    D->blocks[block] = block;
+}
+
+void blocked_build(void *S, value n, const word *bits) {
+    // Construct the blocks with all paths compressed
+    blocked_set *D = S;
+    value n_blocks = (n + 2 + BLOCK - 1) / BLOCK;
+    for (value i = n + 2; i < n_blocks * BLOCK; i++) {
+        D->local[i] = i % BLOCK;
+    }
+    D->blocks[n_blocks] = n_blocks;
+    D->blocks[n_blocks + 1] = n_blocks + 1;
+    build_intervals(n, bits, blocked_build_interval, D);
+}
+
+const Algorithm alg_blocked = {"successor, 2-pass, blocked", blocked_allocate, blocked_free, blocked_init, blocked_delete, blocked_successor, .build = blocked_build, .delete_range = blocked_delete_range};
+
+// ================================================================
+//  Hierarchy of microsets, where level l + 1 has a bit for each word 
+//  at level l, that is set if and only if the word is non-zero
+// ================================================================
+
+typedef struct {
+    value levels;               // number of levels, the top level is a single word
+    word *level[MAX_LEVELS];    // level[0] = the microsets of the elements
+} hierarchy_set;
+
+void *hierarchy_allocate(value max_n) {
+    hierarchy_set *H = memory_calloc(1, sizeof(hierarchy_set));  // unused levels are NULL
+    value n_words = max_n + 2;
+    for (value l = 0; l == 0 || n_words > 1; l++) {
+        assert(l < MAX_LEVELS);
+        n_words = (n_words + WORD_SIZE - 1) / WORD_SIZE;
+        H->level[l] = memory_malloc(n_words * sizeof(word));
+    }
+    return H;
+}
+
+void hierarchy_free(void *S) {
+    hierarchy_set *H = S;
+    for (value l = 0; l < MAX_LEVELS && H->level[l] != NULL; l++) {
+        memory_free(H->level[l]);
+    }
+    memory_free(H);
+}
+
+value hierarchy_levels(value n) {
+    // Number of levels for the set {0, ..., n + 1}
+    value levels = 1;
+    for (value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE; n_words > 1; n_words = (n_words + WORD_SIZE - 1) / WORD_SIZE) {
+        levels++;
+    }
+    return levels;
+}
+
+void hierarchy_init(void *S, value n) {
+    hierarchy_set *H = S;
+    value n_bits = n + 2;
+    value l = 0;
+    while (l == 0 || n_bits > 1) {
+        value n_words = (n_bits + WORD_SIZE - 1) / WORD_SIZE;
+        for (value i = 0; i < n_words; i++) {
+            H->level[l][i] = (word) -1;  // all ones
+        }
+        if (l > 0 && n_bits % WORD_SIZE != 0) {
+            H->level[l][n_words - 1] = ((word) 1 << (n_bits % WORD_SIZE)) - 1;
+        }
+        n_bits = n_words;
+        l++;
+    }
+    H->levels = l;
+}
+
+void hierarchy_delete(void *S, value i) {
+    hierarchy_set *H = S;
+    for (value l = 0; l < H->levels; l++) {
+        word *W = &H->level[l][i / WORD_SIZE];
+        word mask = (word) 1 << (i % WORD_SIZE);
+        if (!(*W & mask)) {
+            return;  // already deleted
+        }
+        *W ^= mask;
+        if (*W != 0) {
+            return;
+        }
+        i /= WORD_SIZE;
+    }
+}
+
+void hierarchy_delete_range(void *S, value l, value r) {
+    // The words that become zero at a level are a range of bits at the level above
+    hierarchy_set *H = S;
+    for (value level = 0; level < H->levels && l <= r; level++) {
+        words_clear_range(H->level[level], l, r, &l, &r);
+    }
+}
+
+void hierarchy_insert(void *S, value i) {
+    // Set the bits up to the first word that was already non-zero
+    hierarchy_set *H = S;
+    for (value l = 0; l < H->levels; l++) {
+        word *W = &H->level[l][i / WORD_SIZE];
+        word before = *W;
+        *W |= (word) 1 << (i % WORD_SIZE);
+        if (before != 0) {
+            return;
+        }
+        i /= WORD_SIZE;
+    }
+}
+
+value hierarchy_successor(void *S, value i) {
+    hierarchy_set *H = S;
+    // Go up until a word with a set bit at or after position i
+    value l = 0;
+    word high_bits;
+    while (!(high_bits = H->level[l][i / WORD_SIZE] & ~(((word) 1 << (i % WORD_SIZE)) - 1))) {
+        i = i / WORD_SIZE + 1;
+        l++;
+    }
+    i = i - i % WORD_SIZE + __builtin_ctzll(high_bits);
+    // Go down following the left-most set bits
+    while (l > 0) {
+        l--;
+        i = i * WORD_SIZE + __builtin_ctzll(H->level[l][i]);
+    }
+    return i;
+}
+
+value hierarchy_predecessor(void *S, value i) {
+    hierarchy_set *H = S;
+    // Go up until a word with a set bit at or before position i
+    value l = 0;
+    word low_bits;
+    while (!(low_bits = H->level[l][i / WORD_SIZE] & (((word) 2 << (i % WORD_SIZE)) - 1))) {
+        i = i / WORD_SIZE - 1;
+        l++;
+    }
+    i = i - i % WORD_SIZE + WORD_SIZE - 1 - __builtin_clzll(low_bits);
+    // Go down following the right-most set bits
+    while (l > 0) {
+        l--;
+        i = i * WORD_SIZE + WORD_SIZE - 1 - __builtin_clzll(H->level[l][i]);
+    }
+    return i;
+}
+
+void hierarchy_build(void *S, value n, const word *bits) {
+    // Copy the bits to level 0, and build each level from the level below
+    hierarchy_set *H = S;
+    H->levels = hierarchy_levels(n);
+    value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    const word *below = bits;
+    for (value l = 0; l + 1 < H->levels; l++) {
+        microset_build_task task = {below, H->level[l], H->level[l + 1]};
+        parallel_for_words(n_words, microset_build_words, &task);
+        n_words = (n_words + WORD_SIZE - 1) / WORD_SIZE;
+        below = H->level[l + 1];
+    }
+    if (H->levels == 1) {
+        H->level[0][0] = bits[0];
+    }
+}
+
+const Algorithm alg_hierarchy = {"microset hierarchy", hierarchy_allocate, hierarchy_free, hierarchy_init, hierarchy_delete, hierarchy_successor, .predecessor = hierarchy_predecessor, .build = hierarchy_build, .delete_range = hierarchy_delete_range, .insert = hierarchy_insert};
+
+// ================================================================
+//  Published snapshots of a microset hierarchy for read-heavy concurrent
+//  use by the left-right technique (Ramalhete and Correia), where a 
+//  single writer deletes in one copy, while readers query the other copy,
+//  the published snapshot, without writes to the hierarchy. Publishing
+//  swaps the copies, waits until no reader uses the old copy, and replays
+//  the pending deletes on it. Readers never wait, and only write their 
+//  own read indicator, a counter in its own cache line.
+// ================================================================
+
+#define SNAPSHOT_BATCH 1024  // deletes between automatic publishing
+
+typedef struct {
+    _Atomic long long count;  // readers using the version
+    char padding[64 - sizeof(long long)];
+} read_indicator;
+
+typedef struct {
+    read_indicator indicator[2][MAX_THREADS];  // [version][reader slot]
+    hierarchy_set *copy[2];     // readers query copy[left_right], the writer copy[!left_right]
+    _Atomic int left_right;
+    _Atomic int version;        // readers arrive at indicator[version]
+    value *pending;             // deletes in copy[!left_right] but not in copy[left_right]
+    size_t n_pending;
+} snapshot_set;
+
+_Thread_local int snapshot_reader = -1;  // reader slot of the thread, shared if more than MAX_THREADS readers
+atomic_int snapshot_readers = 0;
+
+void *snapshot_allocate(value max_n) {
+    snapshot_set *P = memory_aligned(sizeof(snapshot_set));
+    for (int v = 0; v < 2; v++) {
+        for (int t = 0; t < MAX_THREADS; t++) {
+            atomic_init(&P->indicator[v][t].count, 0);
+        }
+        P->copy[v] = hierarchy_allocate(max_n);
+    }
+    P->pending = memory_malloc(SNAPSHOT_BATCH * sizeof(value));
+    return P;
+}
+
+void snapshot_free(void *S) {
+    snapshot_set *P = S;
+    hierarchy_free(P->copy[0]);
+    hierarchy_free(P->copy[1]);
+    memory_free(P->pending);
+    memory_free(P);
+}
+
+void snapshot_init(void *S, value n) {
+    snapshot_set *P = S;
+    hierarchy_init(P->copy[0], n);
+    hierarchy_init(P->copy[1], n);
+    atomic_store(&P->left_right, 0);
+    atomic_store(&P->version, 0);
+    P->n_pending = 0;
+}
+
+void snapshot_build(void *S, value n, const word *bits) {
+    snapshot_set *P = S;
+    hierarchy_build(P->copy[0], n, bits);
+    hierarchy_build(P->copy[1], n, bits);
+    atomic_store(&P->left_right, 0);
+    atomic_store(&P->version, 0);
+    P->n_pending = 0;
+}
+
+value snapshot_successor(void *S, value i) {
+    // Wait-free successor in the published snapshot
+    snapshot_set *P = S;
+    if (snapshot_reader < 0) {
+        snapshot_reader = atomic_fetch_add(&snapshot_readers, 1) % MAX_THREADS;
+    }
+    int v = atomic_load(&P->version);
+    atomic_fetch_add(&P->indicator[v][snapshot_reader].count, 1);
+    value r = hierarchy_successor(P->copy[atomic_load(&P->left_right)], i);
+    atomic_fetch_sub_explicit(&P->indicator[v][snapshot_reader].count, 1, memory_order_release);
+    return r;
+}
+
+void snapshot_wait(snapshot_set *P, int v) {
+    // Wait until no reader has arrived at version v
+    for (int t = 0; t < MAX_THREADS; t++) {
+        while (atomic_load_explicit(&P->indicator[v][t].count, memory_order_acquire) != 0) {
+            sched_yield();
+        }
+    }
+}
+
+void snapshot_publish(void *S) {
+    // Make the pending deletes visible to readers, and then replay them on
+    // the old snapshot, which becomes the copy of the writer
+    snapshot_set *P = S;
+    int lr = atomic_load_explicit(&P->left_right, memory_order_relaxed);
+    atomic_store(&P->left_right, !lr);
+    int v = atomic_load_explicit(&P->version, memory_order_relaxed);
+    snapshot_wait(P, !v);
+    atomic_store(&P->version, !v);
+    snapshot_wait(P, v);
+    for (size_t j = 0; j < P->n_pending; j++) {
+        hierarchy_delete(P->copy[lr], P->pending[j]);
+    }
+    P->n_pending = 0;
+}
+
+void snapshot_delete(void *S, value i) {
+    snapshot_set *P = S;
+    hierarchy_delete(P->copy[!atomic_load_explicit(&P->left_right, memory_order_relaxed)], i);
+    P->pending[P->n_pending++] = i;
+    if (P->n_pending == SNAPSHOT_BATCH) {
+        snapshot_publish(P);
+    }
+}
+
+value snapshot_writer_successor(void *S, value i) {
+    // Successor for the writer, including the pending deletes
+    snapshot_set *P = S;
+    return hierarchy_successor(P->copy[!atomic_load_explicit(&P->left_right, memory_order_relaxed)], i);
+}
+
+value snapshot_writer_predecessor(void *S, value i) {
+    snapshot_set *P = S;
+    return hierarchy_predecessor(P->copy[!atomic_load_explicit(&P->left_right, memory_order_relaxed)], i);
+}
+
+const Algorithm alg_snapshot = {"microset hierarchy, snapshot", snapshot_allocate, snapshot_free, snapshot_init, snapshot_delete, snapshot_writer_successor, .predecessor = snapshot_writer_predecessor, .build = snapshot_build, .snapshot_successor = snapshot_successor, .publish = snapshot_publish};
+
+// ================================================================
+//  Sharded structure, where {0, ..., n + 1} is split into SHARDS 
+//  contiguous ranges of a power of two elements, each a structure of an engine 
+//  algorithm, and a summary word has a bit for each non-empty shard.
+//  The minimum of each shard is maintained by the delete operations, so 
+//  a successor query crossing a shard boundary only reads the summary
+//  and the minimum of the next non-empty shard, and operations on 
+//  different shards by different threads never access the same structure.
+// ================================================================
+
+#define SHARDS 64  // shards of the universe, the summary is a single word
+
+typedef struct {
+    void *local;         // engine structure, where element i of the shard is local i - base
+    value size;          // elements in the shard, 0 if unused
+    atomic_value first;  // min element of the shard, written only by delete in the shard
+    char padding[64 - sizeof(void *) - 2 * sizeof(value)];
+} shard;
+
+typedef struct {
+    shard shard[SHARDS];
+    const Algorithm *alg;  // engine for the shards
+    value n;
+    int shift;             // shard k has the elements [k << shift, (k + 1) << shift) of {0, ..., n + 1}
+    _Atomic word summary;  // bit k is set if and only if shard k is non-empty
+} sharded_set;
+
+int shard_shift(value n) {
+    // Smallest shift with SHARDS shards of 2^shift elements covering {0, ..., n + 1}
+    int shift = 0;
+    while (((value) SHARDS << shift) < n + 2) {
+        shift++;
+    }
+    return shift;
+}
+
+int element_shard(value n, value i) {
+    // Shard of element i in a sharded set of size n
+    return i >> shard_shift(n);
+}
+
+int shard_count(value n) {
+    // Non-empty shards of a sharded set of size n
+    return element_shard(n, n + 1) + 1;
+}
+
+void *sharded_allocate(const Algorithm *alg, value max_n) {
+    sharded_set *H = memory_aligned(sizeof(sharded_set));
+    H->alg = alg;
+    for (int k = 0; k < SHARDS; k++) {
+        H->shard[k].local = alg->create((value) 1 << shard_shift(max_n));
+    }
+    return H;
+}
+
+void sharded_free(void *S) {
+    sharded_set *H = S;
+    for (int k = 0; k < SHARDS; k++) {
+        H->alg->destroy(H->shard[k].local);
+    }
+    memory_free(H);
+}
+
+void sharded_init(void *S, value n) {
+    sharded_set *H = S;
+    H->n = n;
+    H->shift = shard_shift(n);
+    value width = (value) 1 << H->shift;
+    word summary = 0;
+    for (int k = 0; k < SHARDS; k++) {
+        value size = n + 2 - k * width;
+        size = size < 0 ? 0 : size < width ? size : width;
+        H->shard[k].size = size;
+        if (size > 0) {
+            H->alg->init(H->shard[k].local, size);
+            summary |= (word) 1 << k;
+        }
+        atomic_init(&H->shard[k].first, k * width);
+    }
+    atomic_init(&H->summary, summary);
+}
+
+value sharded_successor(void *S, value i) {
+    sharded_set *H = S;
+    int k = i >> H->shift;
+    value base = ((value) k << H->shift) - 1;  // element base + j of the shard is local j in {1, ..., size}
+    value s = H->alg->successor(H->shard[k].local, i - base);
+    if (s <= H->shard[k].size) {
+        return base + s;
+    }
+    // The shard containing n + 1 is never empty
+    word next = atomic_load_explicit(&H->summary, memory_order_acquire) & ((word) -2 << k);
+    return atomic_load_explicit(&H->shard[__builtin_ctzll(next)].first, memory_order_acquire);
+}
+
+void sharded_delete(void *S, value i) {
+    // Delete i, and update the min of the shard if i is the min, or the 
+    // summary if the shard becomes empty, leaving first as a stale min
+    sharded_set *H = S;
+    int k = i >> H->shift;
+    value base = ((value) k << H->shift) - 1;
+    H->alg->delete(H->shard[k].local, i - base);
+    if (atomic_load_explicit(&H->shard[k].first, memory_order_relaxed) == i) {
+        value s = H->alg->successor(H->shard[k].local, i - base + 1);
+        if (s <= H->shard[k].size) {
+            atomic_store_explicit(&H->shard[k].first, base + s, memory_order_release);
+        } else {
+            atomic_fetch_and_explicit(&H->summary, ~((word) 1 << k), memory_order_release);
+        }
+    }
+}
+
+void *DS_sharded_allocate(value max_n) {
+    return sharded_allocate(&alg_2pass, max_n);
+}
+
+void *DS_microset_sharded_allocate(value max_n) {
+    return sharded_allocate(&alg_ds_microset, max_n);
+}
+
+const Algorithm alg_2pass_sharded = {"successor, 2-pass, sharded", DS_sharded_allocate, sharded_free, sharded_init, sharded_delete, sharded_successor, .sharded = 1};
+const Algorithm alg_ds_microset_sharded = {"successor, 2-pass, microset, sharded", DS_microset_sharded_allocate, sharded_free, sharded_init, sharded_delete, sharded_successor, .sharded = 1};
+
+// ================================================================
+//  Adaptive structure, that samples its operations in windows of 
+//  operations, and at the end of a window migrates online to the 
+//  representation preferred for the operations in the window, by 
+//  extracting the set to a bitmap and a bulk build of the representation:
+//  - a halving array while the array is small enough to be cached and
+//    Succ follows few links,
+//  - a quick-find microset for large n or long paths,
+//  - a microset hierarchy while Insert is used.
+// ================================================================
+
+#define ADAPTIVE_ARRAY 0           // representations
+#define ADAPTIVE_MICROSET 1
+#define ADAPTIVE_HIERARCHY 2
+#define ADAPTIVE_ALGORITHMS 3
+#define ADAPTIVE_WINDOW 1024       // a window is n / 4 + ADAPTIVE_WINDOW operations
+#define ADAPTIVE_ARRAY_N (1 << 17) // max n for the array
+#define ADAPTIVE_SAMPLED 1024      // Succ in the array count their links in the first operations of a window
+#define ADAPTIVE_HOPS 1.5          // max mean links followed by the sampled Succ
+#define ADAPTIVE_LONG_WINDOWS 2    // consecutive windows with long paths before leaving the array
+
+const Algorithm *adaptive_algorithms[ADAPTIVE_ALGORITHMS] = {&alg_halving, &alg_qf_microset, &alg_hierarchy};
+
+typedef struct {
+    void *S[ADAPTIVE_ALGORITHMS];  // a structure for each representation, only S[current] is up to date
+    int current;
+    value n;
+    value countdown;               // operations left in the window
+    value sampled_until;           // Succ count links while countdown > sampled_until
+    value inserts;                 // in the window
+    value samples, hops;           // sampled Succ in the array in the window, and the links they followed
+    int long_windows;              // consecutive windows with long paths in the array
+} adaptive_set;
+
+void *adaptive_allocate(value max_n) {
+    // All representations are allocated by create, as required for a 
+    // persistent structure
+    adaptive_set *D = memory_malloc(sizeof(adaptive_set));
+    for (int r = 0; r < ADAPTIVE_ALGORITHMS; r++) {
+        D->S[r] = adaptive_algorithms[r]->create(max_n);
+    }
+    return D;
+}
+
+void adaptive_free(void *S) {
+    adaptive_set *D = S;
+    for (int r = 0; r < ADAPTIVE_ALGORITHMS; r++) {
+        adaptive_algorithms[r]->destroy(D->S[r]);
+    }
+    memory_free(D);
+}
+
+void adaptive_window(adaptive_set *D) {
+    D->countdown = D->n / 4 + ADAPTIVE_WINDOW;
+    D->sampled_until = D->countdown - ADAPTIVE_SAMPLED;
+    D->inserts = D->samples = D->hops = 0;
+}
+
+void adaptive_start(adaptive_set *D, value n) {
+    D->n = n;
+    D->current = n <= ADAPTIVE_ARRAY_N ? ADAPTIVE_ARRAY : ADAPTIVE_MICROSET;
+    D->long_windows = 0;
+    adaptive_window(D);
+}
+
+void adaptive_init(void *S, value n) {
+    adaptive_set *D = S;
+    adaptive_start(D, n);
+    adaptive_algorithms[D->current]->init(D->S[D->current], n);
+}
+
+void adaptive_build(void *S, value n, const word *bits) {
+    adaptive_set *D = S;
+    adaptive_start(D, n);
+    adaptive_algorithms[D->current]->build(D->S[D->current], n, bits);
+}
+
+word *adaptive_bits(adaptive_set *D) {
+    // The set as a bitmap, where the microset and the hierarchy already 
+    // contain the bitmap, with bits after n + 1 set by init
+    value n_words = (D->n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    word *bits;
+    if (D->current == ADAPTIVE_ARRAY) {
+        const value *A = D->S[ADAPTIVE_ARRAY];
+        bits = calloc(n_words, sizeof(word));
+        for (value i = 0; i < D->n + 2; i++) {
+            bits[i / WORD_SIZE] |= (word) (A[i] == i) << (i % WORD_SIZE);
+        }
+    } else {
+        const word *W = D->current == ADAPTIVE_MICROSET
+            ? ((microset_set *) D->S[ADAPTIVE_MICROSET])->microsets
+            : ((hierarchy_set *) D->S[ADAPTIVE_HIERARCHY])->level[0];
+        bits = malloc(n_words * sizeof(word));
+        memcpy(bits, W, n_words * sizeof(word));
+    }
+    if ((D->n + 2) % WORD_SIZE != 0) {
+        bits[n_words - 1] &= ((word) 1 << ((D->n + 2) % WORD_SIZE)) - 1;
+    }
+    return bits;
+}
+
+void adaptive_migrate(adaptive_set *D, int r) {
+    word *bits = adaptive_bits(D);
+    adaptive_algorithms[r]->build(D->S[r], D->n, bits);
+    free(bits);
+    D->current = r;
+}
+
+int adaptive_choice(adaptive_set *D) {
+    // Representation for the next window, from the operations in the window
+    if (D->inserts > 0) {
+        return ADAPTIVE_HIERARCHY;
+    }
+    if (D->current == ADAPTIVE_ARRAY) {
+        // One window of long paths, e.g., after many deletes without Succ,
+        // is compressed by the halving
+        D->long_windows = D->hops > ADAPTIVE_HOPS * D->samples ? D->long_windows + 1 : 0;
+        return D->long_windows < ADAPTIVE_LONG_WINDOWS ? ADAPTIVE_ARRAY : ADAPTIVE_MICROSET;
+    }
+    if (D->current == ADAPTIVE_HIERARCHY && D->n <= ADAPTIVE_ARRAY_N) {
+        D->long_windows = 0;
+        return ADAPTIVE_ARRAY;
+    }
+    return ADAPTIVE_MICROSET;
+}
+
+void adaptive_window_end(adaptive_set *D) {
+    int r = adaptive_choice(D);
+    if (r != D->current) {
+        adaptive_migrate(D, r);
+    }
+    adaptive_window(D);
+}
+
+value adaptive_array_successor(adaptive_set *D, value i) {
+    // successor_halving, where only sampled Succ count their links, since
+    // counting in every Succ costs more than the Succ on random inputs
+    value *A = D->S[ADAPTIVE_ARRAY];
+    if (D->countdown <= D->sampled_until) {
+        return successor_halving(A, i);
+    }
+    D->samples++;
+    while (i < A[i]) {
+        if (COUNTS) count_links++, count_write(&A[i]);
+        i = A[i] = A[A[i]];
+        D->hops++;
+    }
+    return i;
+}
+
+value adaptive_successor(void *S, value i) {
+    adaptive_set *D = S;
+    value s = D->current == ADAPTIVE_ARRAY ? adaptive_array_successor(D, i)
+        : D->current == ADAPTIVE_MICROSET ? QF_microset_successor(D->S[ADAPTIVE_MICROSET], i)
+        : hierarchy_successor(D->S[ADAPTIVE_HIERARCHY], i);
+    if (--D->countdown == 0) {
+        adaptive_window_end(D);
+    }
+    return s;
+}
+
+void adaptive_delete(void *S, value i) {
+    adaptive_set *D = S;
+    if (D->current == ADAPTIVE_ARRAY) {
+        delete(D->S[ADAPTIVE_ARRAY], i);
+    } else if (D->current == ADAPTIVE_MICROSET) {
+        QF_microset_delete(D->S[ADAPTIVE_MICROSET], i);
+    } else {
+        hierarchy_delete(D->S[ADAPTIVE_HIERARCHY], i);
+    }
+    if (--D->countdown == 0) {
+        adaptive_window_end(D);
+    }
+}
+
+void adaptive_delete_range(void *S, value l, value r) {
+    adaptive_set *D = S;
+    adaptive_algorithms[D->current]->delete_range(D->S[D->current], l, r);
+    if (--D->countdown == 0) {
+        adaptive_window_end(D);
+    }
+}
+
+void adaptive_insert(void *S, value i) {
+    // Only the hierarchy supports Insert, so migrate at once
+    adaptive_set *D = S;
+    D->inserts++;
+    if (D->current != ADAPTIVE_HIERARCHY) {
+        adaptive_migrate(D, ADAPTIVE_HIERARCHY);
+    }
+    hierarchy_insert(D->S[ADAPTIVE_HIERARCHY], i);
+    if (--D->countdown == 0) {
+        adaptive_window_end(D);
+    }
+}
+
+const Algorithm alg_adaptive = {"adaptive", adaptive_allocate, adaptive_free, adaptive_init, adaptive_delete, adaptive_successor, .build = adaptive_build, .delete_range = adaptive_delete_range, .insert = adaptive_insert};
+
+// ================================================================
+//   Successor-delete data structure from pseudocode in the paper 
+//   modified to maintain reverse pointers and heights of subtrees;
+//   T_deepest_node() returns a node with maximum depth. 
+//
+//   The children of a node are partitioned into groups of children of
+//   equal height, and the groups are kept in a list sorted by decreasing
+//   height, so that the height of a node is one plus the height of its 
+//   first group, and a deepest leaf is found by following for each node
+//   a child in its first group.
+// ================================================================
+
+typedef struct {
+    value parent;       // parent node, i,e, A[i] >= i
+    value height;       // height of subtree rooted at this node
+    value next, prev;   // double-linked list of all nodes with equal height
+    value left, right;  // double-linked list of siblings in the same group
+    value group;        // group containing this node in its parent, or -1
+    value groups;       // group of children with max height, or -1
+    value deepest;      // a child in groups, or -1
+} successor_delete_node;
+
+typedef struct {
+    value height;       // height of the children in the group
+    value first;        // a child in the group
+    value next, prev;   // double-linked list of groups, sorted by decreasing height
+} child_group;
+
+successor_delete_node *nodes;  // global successor-delete array
+child_group *groups;    // groups of children, unused groups are linked by next
+value free_groups;      // first unused group
+value *roots;           // roots[height] = a node with height h
+value max_height;       // max height of all trees
+value *path;            // path to the root in T_successor
+
+void T_allocate(value max_n) {
+    nodes = memory_malloc((max_n + 2) * sizeof(successor_delete_node));
+    groups = memory_malloc((max_n + 2) * sizeof(child_group));
+    roots = memory_malloc((max_n + 2) * sizeof(value));
+    path = memory_malloc((max_n + 2) * sizeof(value));
+}
+
+void T_init(value n) {
+    // Initialize the successor-delete structure to n + 2 singleton trees
+    for (value i = 0; i < n + 2; i++) {
+        nodes[i].parent = i;
+        nodes[i].height = 0;
+        nodes[i].left = i;
+        nodes[i].right = i;
+        nodes[i].group = -1;
+        nodes[i].groups = -1;
+        nodes[i].deepest = -1;
+        nodes[i].next = i + 1;
+        nodes[i].prev = i - 1;
+        roots[i] = -1;
+        groups[i].next = i + 1 < n + 2 ? i + 1 : -1;
+    }
+    nodes[0].prev = n + 1;
+    nodes[n + 1].next = 0;
+    max_height = 0;
+    roots[0] = 0;
+    free_groups = 0;
+}
+
+void T_set_height(value i, value h) {
+    // Set height of node i, and update the lists nodes of equal height
+    value next = nodes[i].next;
+    value prev = nodes[i].prev;
+    if (roots[nodes[i].height] == i) {
+        roots[nodes[i].height] = next != i ? next : -1;
+    }
+    if (next != i) {
+        nodes[next].prev = prev;
+        nodes[prev].next = next;
+        nodes[i].next = i;
+        nodes[i].prev = i;
+    }
+    nodes[i].height = h;
+    if (roots[h] != -1) {
+        next = roots[h];
+        prev = nodes[next].prev;
+        nodes[i].next = next;   
+        nodes[i].prev = prev;
+        nodes[next].prev = i;
+        nodes[prev].next = i;
+    }
+    roots[h] = i;
+    if (h > max_height) {
+        max_height = h;
+    }
+}
+
+void T_add_child(value i, value j) {
+    // Add i with parent j to the group of j for the height of i
+    value h = nodes[i].height;
+    value g = nodes[j].groups, prev = -1;
+    while (g != -1 && groups[g].height > h) {
+        prev = g;
+        g = groups[g].next;
+    }
+    if (g == -1 || groups[g].height < h) {
+        // Create new group between prev and g
+        value new = free_groups;
+        free_groups = groups[new].next;
+        groups[new] = (child_group) {h, i, g, prev};
+        if (g != -1) {
+            groups[g].prev = new;
+        }
+        if (prev != -1) {
+            groups[prev].next = new;
+        } else {
+            nodes[j].groups = new;
+        }
+        nodes[i].left = i;
+        nodes[i].right = i;
+        nodes[i].group = new;
+        return;
+    }
+    value right = groups[g].first;
+    value left = nodes[right].left;
+    nodes[i].right = right;
+    nodes[i].left = left;
+    nodes[right].left = i;
+    nodes[left].right = i;
+    nodes[i].group = g;
+}
+
+void T_remove_child(value i, value j) {
+    // Remove i from its group in j, and remove the group if it becomes empty
+    value g = nodes[i].group;
+    value left = nodes[i].left;
+    value right = nodes[i].right;
+    if (right != i) {
+        nodes[left].right = right;
+        nodes[right].left = left;
+        groups[g].first = right;
+    } else {
+        value next = groups[g].next, prev = groups[g].prev;
+        if (next != -1) {
+            groups[next].prev = prev;
+        }
+        if (prev != -1) {
+            groups[prev].next = next;
+        } else {
+            nodes[j].groups = next;
+        }
+        groups[g].next = free_groups;
+        free_groups = g;
+    }
+    nodes[i].left = i;
+    nodes[i].right = i;
+    nodes[i].group = -1;
+}
+
+void T_fix_heights(value j) {
+    // Recompute the height of j, and of its ancestors while heights change
+    while (1) {
+        value g = nodes[j].groups;
+        nodes[j].deepest = g == -1 ? -1 : groups[g].first;
+        value h = g == -1 ? 0 : groups[g].height + 1;
+        if (h == nodes[j].height) {
+            return;
+        }
+        value parent = nodes[j].parent;
+        if (parent != j) {
+            T_remove_child(j, parent);
+        }
+        T_set_height(j, h);
+        if (parent == j) {
+            return;
+        }
+        T_add_child(j, parent);
+        j = parent;
+    }
+}
+
+void T_link(value i, value j) {
+    // Make i a child of j
+    assert(nodes[i].parent == i);
+    nodes[i].parent = j;
+    T_add_child(i, j);
+    T_fix_heights(j);
+}
+
+void T_unlink(value i) {
+    // Remove i from the children of its parent
+    value j = nodes[i].parent;
+    assert(j > i);
+    T_remove_child(i, j);
+    nodes[i].parent = i;
+    T_fix_heights(j);
+}
+
+void T_delete(value i) {
+    if (nodes[i].parent > i) {
+        T_unlink(i);
+    }
+    T_link(i, i + 1);
+    // Adjust max_height, if it has decreased
+    while (roots[max_height] == -1) {
+        max_height--;
+    }
+}
+
+value T_successor(value i) {
+    // 2-pass path compression
+    value root = i, length = 0;
+    // Find root
+    while (root < nodes[root].parent) {
+        path[length++] = root;
+        root = nodes[root].parent;
+    }
+    // Path compression top-down, such that only the parent of a node
+    // and the root need to update their heights
+    for (value k = length - 2; k >= 0; k--) {
+        T_unlink(path[k]);
+        T_link(path[k], root);
+    }
+    // Adjust max_height, if it has decreased
+    while (roots[max_height] == -1) {
+        max_height--;
+    }
+    return root;
+}    
+
+value T_deepest_leaf(value i) {
+    // Find a deepest node in tree rooted at i
+    while (nodes[i].deepest != -1) {
+        i = nodes[i].deepest;
+    }    
+    return i;
+}    
+
+value T_deepest_node() {
+    // Return a node with maximum depth
+    return T_deepest_leaf(roots[max_height]);
+}    
+
+void T_validate(value n) {
+    // Validate integrity of all nodes
+    value uncounted_children = 0;
+    for (value i=0; i < n + 2; i++) {
+        value parent = nodes[i].parent, 
+              next = nodes[i].next, 
+              prev = nodes[i].prev, 
+              left = nodes[i].left, 
+              right = nodes[i].right, 
+              height = nodes[i].height;
+        assert(i <= parent && parent < n + 2);
+        if (parent != i) {
+            uncounted_children++;   
+        }
+        assert(height >= 0);
+        if (height == 0) {
+            assert(nodes[i].groups == - 1 && nodes[i].deepest == -1);
+        } else {
+            value g = nodes[i].groups;
+            assert(0 <= g && g < n + 2);
+            assert(groups[g].prev == -1);
+            assert(height == groups[g].height + 1);
+            assert(nodes[i].deepest == groups[g].first);
+            for (; g != -1; g = groups[g].next) {
+                // Groups have decreasing heights, and contain children of i
+                assert(groups[g].next == -1 || groups[groups[g].next].height < groups[g].height);
+                assert(groups[g].next == -1 || groups[groups[g].next].prev == g);
+                value c = groups[g].first;
+                do {
+                    assert(nodes[c].parent == i && c < i);
+                    assert(nodes[c].group == g);
+                    assert(nodes[c].height == groups[g].height);
+                    uncounted_children--;
+                    c = nodes[c].right;
+                } while (c != groups[g].first);
+            }
+        }
+        assert(0 <= next && next < n + 2);
+        assert(0 <= prev && prev < n + 2);
+        assert(nodes[next].prev == i);
+        assert(nodes[prev].next == i);
+        assert(height == nodes[next].height);
+        assert(height == nodes[prev].height);
+        
+        assert(0 <= left && left < n + 2);
+        assert(0 <= right && right < n + 2);
+        assert(nodes[right].left == i);
+        assert(nodes[left].right == i);
+        assert(nodes[right].parent == parent);
+        assert(nodes[left].parent == parent);
+        assert((parent == i) == (nodes[i].group == -1));
+    }
+    value nodes_found = 0;
+    for (value h = 0; h <= max_height; h++) {
+        value root = roots[h];
+        assert(0 <= root && root < n + 2);
+        assert(nodes[root].height == h);
+        nodes_found++;
+        while (nodes[root].next != roots[h]) {
+            root = nodes[root].next;
+            assert(nodes[root].height == h);
+            nodes_found++;
+        }
+    }
+    assert(uncounted_children == 0);
+    assert(nodes_found == n + 2);
+}
+
+// ================================================================
+//  Struct to store test data = sequence of operations
+// ================================================================
+
+struct {
+    value n;        // initial set size {1,...,n}
+    char name[100]; // text buffer for name of the current test data
+    value *input;   // successor(x) for x >= 1, delete(-x) for x <= - 1, 0 = end,
+                    // predecessor(x) for x | OP_PRED, delete_range for -range_op(l, r),
+                    // insert(x) for x | OP_INSERT
+    value *output;  // answers to all input operations, 0 for delete and insert
+    int extended;   // input contains operations other than successor and delete
+} data;
+
+void data_allocate(value max_m) {
+    data.input = malloc((max_m + 1) * sizeof(value));
+    data.output = malloc((max_m + 1) * sizeof(value));
+}
+
+value range_op(value l, value r) {
+    // DeleteRange(l, r) packed as l | OP_RANGE | (r - l) << RANGE_SHIFT
+    assert(1 <= l && l <= r && l < (value) 1 << RANGE_SHIFT && r - l < OP_RANGE >> RANGE_SHIFT);
+    return l | OP_RANGE | (r - l) << RANGE_SHIFT;
+}
+
+value range_l(value op) {
+    return op & (((value) 1 << RANGE_SHIFT) - 1);
+}
+
+value range_r(value op) {
+    return range_l(op) + ((op ^ OP_RANGE) >> RANGE_SHIFT);
+}
+
+value operation(const Algorithm *alg, void *S, value x) {
+    // Perform the operation x from test data on structure S, and return its answer
+    if (x >= 0) {
+        if (x & OP_INSERT) {
+            alg->insert(S, x ^ OP_INSERT);
+            return 0;
+        }
+        if (x & OP_PRED) {
+            return alg->predecessor(S, x ^ OP_PRED);
+        }
+        return alg->successor(S, x);
+    } else if (-x & OP_RANGE) {
+        batch_delete_range(alg, S, range_l(-x), range_r(-x));
+        return 0;
+    } else {
+        alg->delete(S, -x);
+        return 0;
+    }
+}
+
+void data_set_output(const Algorithm *alg) {
+    // Set data.output using data.input and algorithm alg
+    value n = data.n;
+    void *S = alg->create(n);
+    alg->init(S, n);
+    value *out = data.output;
+    data.extended = 0;
+    for (value *p = data.input; *p != 0; p++) {
+        value x = *p;
+        if ((x > 0 && (x & (OP_PRED | OP_INSERT))) || (x < 0 && (-x & OP_RANGE))) {
+            data.extended = 1;
+        }
+        *(out++) = operation(alg, S, x);
+    }
+    alg->destroy(S);
+}
+
+void validate(const Algorithm *alg) {
+    // Check if successor-delete algorithm alg generates correct output    
+    void *S = alg->create(data.n);
+    alg->init(S, data.n);
+    for (value *in=data.input, *out=data.output; *in != 0; in++, out++) {
+        value x = *in;
+        if (x < 0) {
+            assert(*out == 0);
+            assert(1 <= -x <= data.n);
+        }
+        assert(*out == operation(alg, S, x));
+    }
+    alg->destroy(S);
+}
+
+int compare_values(const void *a, const void *b) {
+    value x = *(const value *) a, y = *(const value *) b;
+    return (x > y) - (x < y);
+}
+
+void batch_input(value **elements, value **runs, int sorted) {
+    // Split data.input into runs of at most BATCH_SIZE successor queries or
+    // deletions; elements = the arguments of all operations in data.input, 
+    // runs = the lengths of the runs, negative for deletions, 0 = end;
+    // the queries in each run are sorted if sorted
+    assert(!data.extended);
+    *elements = malloc((MAX_OPERATIONS + 1) * sizeof(value));
+    *runs = malloc((MAX_OPERATIONS + 1) * sizeof(value));
+    value *e = *elements, *run = *runs;
+    for (value *in = data.input; *in != 0; run++) {
+        value sign = *in > 0 ? 1 : -1;
+        *run = 0;
+        while (*in != 0 && (*in > 0 ? 1 : -1) == sign && *run * sign < BATCH_SIZE) {
+            *(e++) = *(in++) * sign;
+            *run += sign;
+        }
+        if (sorted && *run > 0) {
+            qsort(e - *run, *run, sizeof(value), compare_values);
+        }
+    }
+    *run = 0;
+}
+
+void validate_batched(const Algorithm *alg, int sorted) {
+    // Check if the batched operations of algorithm alg generate correct output,
+    // where the answers to sorted queries are the sorted answers, since 
+    // successor is non-decreasing
+    value *elements, *runs, out[BATCH_SIZE], answers[BATCH_SIZE];
+    batch_input(&elements, &runs, sorted);
+    void *S = alg->create(data.n);
+    alg->init(S, data.n);
+    value *e = elements, *expected = data.output;
+    for (value *run = runs; *run != 0; run++) {
+        if (*run > 0) {
+            memcpy(answers, expected, *run * sizeof(value));
+            if (sorted) {
+                batch_successor_sorted(alg, S, e, out, *run);
+                qsort(answers, *run, sizeof(value), compare_values);
+            } else {
+                batch_successor(alg, S, e, out, *run);
+            }
+            for (value j = 0; j < *run; j++) {
+                assert(out[j] == answers[j]);
+            }
+            e += *run;
+            expected += *run;
+        } else {
+            batch_delete(alg, S, e, -*run);
+            e -= *run;
+            expected -= *run;
+        }
+    }
+    alg->destroy(S);
+    free(elements);
+    free(runs);
+}
+
+// ================================================================
+//  Binary trace files of test data, for replaying traces that are too 
+//  large for data.input, and for sharing traces between machines.
+//
+//  A trace file is TRACE_MAGIC, followed by varints n, the number of
+//  operations, flags, and the length and characters of the name, followed
+//  by chunks of at most TRACE_CHUNK operations. Each chunk is varints 
+//  for the number of operations and the number of bytes of operations, 
+//  an 8 byte little endian checksum of the answers to the operations in 
+//  the chunk if flags has TRACE_CHECKSUMS, and the operations. An 
+//  operation is the varint (zigzag(x - previous x) << 2) | kind, where 
+//  kind = 0 for Succ(x), 1 for Delete(x), 2 for Pred(x), and 3 for an
+//  operation followed by a varint e, where e = 0 for Insert(x) and 
+//  e = r - x + 1 for DeleteRange(x, r).
+// ================================================================
+
+#define TRACE_CHUNK (1 << 16)          // max operations in a chunk
+#define TRACE_CHUNK_BYTES (TRACE_CHUNK * 20)  // max bytes in a chunk
+const char TRACE_MAGIC[8] = "SDTRACE";
+const unsigned long long TRACE_CHECKSUMS = 1;  // chunks contain checksums of answers
+
+typedef struct {
+    unsigned char *file;        // the trace file mapped with mmap
+    size_t size;                // bytes in the file
+    const unsigned char *next;  // next chunk
+    value n;
+    unsigned long long operations, flags;
+    char name[100];
+} trace;
+
+unsigned long long checksum_add(unsigned long long checksum, value answer) {
+    return (checksum ^ (unsigned long long) answer) * 0x100000001b3ULL;
+}
+
+unsigned char *varint_put(unsigned char *p, unsigned long long x) {
+    for (; x >= 128; x >>= 7) {
+        *(p++) = (x & 127) | 128;
+    }
+    *(p++) = x;
+    return p;
+}
+
+unsigned long long varint_get(const unsigned char **p) {
+    unsigned long long x = 0;
+    for (int shift = 0; ; shift += 7) {
+        unsigned char b = *((*p)++);
+        x |= (unsigned long long) (b & 127) << shift;
+        if (b < 128) {
+            return x;
+        }
+    }
+}
+
+void trace_write(const char *filename, int checksums) {
+    // Write data.input, and checksums of data.output if checksums, to filename
+    FILE *f = fopen(filename, "wb");
+    assert(f != NULL);
+    unsigned char *buffer = malloc(TRACE_CHUNK_BYTES + 64);
+    unsigned long long operations = 0;
+    while (data.input[operations] != 0) {
+        operations++;
+    }
+    unsigned char *p = buffer;
+    for (int i = 0; i < 8; i++) {
+        *(p++) = TRACE_MAGIC[i];
+    }
+    p = varint_put(p, data.n);
+    p = varint_put(p, operations);
+    p = varint_put(p, checksums ? TRACE_CHECKSUMS : 0);
+    size_t length = strlen(data.name);
+    p = varint_put(p, length);
+    fwrite(buffer, 1, p - buffer, f);
+    fwrite(data.name, 1, length, f);
+    value previous = 0;
+    for (unsigned long long begin = 0; begin < operations; begin += TRACE_CHUNK) {
+        unsigned long long end = begin + TRACE_CHUNK < operations ? begin + TRACE_CHUNK : operations;
+        unsigned long long checksum = 0;
+        p = buffer;
+        for (unsigned long long i = begin; i < end; i++) {
+            value x = data.input[i];
+            int kind = x < 0 ? ((-x & OP_RANGE) ? 3 : 1) : (x & OP_INSERT) ? 3 : (x & OP_PRED) ? 2 : 0;
+            value arg = kind == 1 ? -x : kind == 2 ? x ^ OP_PRED : kind == 3 ? (x < 0 ? range_l(-x) : x ^ OP_INSERT) : x;
+            long long delta = (long long) arg - previous;
+            p = varint_put(p, ((unsigned long long) delta << 1 ^ (unsigned long long) (delta >> 63)) << 2 | kind);
+            if (kind == 3) {
+                p = varint_put(p, x < 0 ? range_r(-x) - arg + 1 : 0);
+            }
+            previous = arg;
+            checksum = checksum_add(checksum, data.output[i]);
+        }
+        unsigned char chunk_header[32], *q = chunk_header;
+        q = varint_put(q, end - begin);
+        q = varint_put(q, p - buffer);
+        for (int i = 0; checksums && i < 8; i++) {
+            *(q++) = checksum >> (8 * i);
+        }
+        fwrite(chunk_header, 1, q - chunk_header, f);
+        fwrite(buffer, 1, p - buffer, f);
+    }
+    fclose(f);
+    free(buffer);
+}
+
+trace *trace_open(const char *filename) {
+    // Map a trace file into memory, returns NULL if not a trace file
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    trace *T = malloc(sizeof(trace));
+    T->size = lseek(fd, 0, SEEK_END);
+    T->file = T->size >= 8 ? mmap(NULL, T->size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (T->file == MAP_FAILED || memcmp(T->file, TRACE_MAGIC, 8) != 0) {
+        if (T->file != MAP_FAILED) {
+            munmap(T->file, T->size);
+        }
+        free(T);
+        return NULL;
+    }
+    const unsigned char *p = T->file + 8;
+    T->n = varint_get(&p);
+    T->operations = varint_get(&p);
+    T->flags = varint_get(&p);
+    size_t length = varint_get(&p);
+    assert(length < sizeof(T->name));
+    memcpy(T->name, p, length);
+    T->name[length] = '\0';
+    T->next = p + length;
+    madvise(T->file, T->size, MADV_SEQUENTIAL);
+    return T;
+}
+
+void trace_rewind(trace *T) {
+    const unsigned char *p = T->file + 8;
+    for (int field = 0; field < 3; field++) {
+        varint_get(&p);
+    }
+    size_t length = varint_get(&p);
+    T->next = p + length;
+}
+
+value trace_chunk(trace *T, value *input, value *previous, unsigned long long *checksum) {
+    // Decode the next chunk into input, terminated by 0, and set checksum to 
+    // the checksum of its answers; returns the number of operations, 0 at end
+    if (T->next >= T->file + T->size) {
+        return 0;
+    }
+    const unsigned char *p = T->next;
+    value operations = varint_get(&p);
+    size_t bytes = varint_get(&p);
+    *checksum = 0;
+    if (T->flags & TRACE_CHECKSUMS) {
+        for (int i = 0; i < 8; i++) {
+            *checksum |= (unsigned long long) *(p++) << (8 * i);
+        }
+    }
+    T->next = p + bytes;
+    for (value i = 0; i < operations; i++) {
+        unsigned long long tag = varint_get(&p);
+        unsigned long long zigzag = tag >> 2;
+        value arg = *previous + (value) (long long) (zigzag >> 1 ^ -(zigzag & 1));
+        *previous = arg;
+        switch (tag & 3) {
+            case 0: input[i] = arg; break;
+            case 1: input[i] = -arg; break;
+            case 2: input[i] = arg | OP_PRED; break;
+            default: {
+                value e = varint_get(&p);
+                input[i] = e == 0 ? arg | OP_INSERT : -range_op(arg, arg + e - 1);
+                break;
+            }
+        }
+    }
+    input[operations] = 0;
+    return operations;
+}
+
+void trace_close(trace *T) {
+    munmap(T->file, T->size);
+    free(T);
+}
+
+void trace_operations(trace *T, int *preds, int *inserts) {
+    // Set preds and inserts to whether trace T contains Pred and Insert
+    value *input = malloc((TRACE_CHUNK + 1) * sizeof(value)), previous = 0;
+    unsigned long long checksum;
+    *preds = *inserts = 0;
+    trace_rewind(T);
+    while (trace_chunk(T, input, &previous, &checksum) > 0) {
+        for (value *in = input; *in != 0; in++) {
+            *preds |= *in > 0 && (*in & OP_PRED);
+            *inserts |= *in > 0 && (*in & OP_INSERT);
+        }
+    }
+    free(input);
+}
+
+int data_read(const char *filename) {
+    // Read a trace into data, if it fits into data.input, and validate the
+    // checksums of its answers; returns 1 if successful
+    trace *T = trace_open(filename);
+    if (T == NULL || T->operations >= MAX_OPERATIONS) {
+        if (T != NULL) {
+            trace_close(T);
+        }
+        return 0;
+    }
+    data.n = T->n;
+    strcpy(data.name, T->name);
+    value *p = data.input, previous = 0, operations;
+    unsigned long long checksum;
+    while ((operations = trace_chunk(T, p, &previous, &checksum)) > 0) {
+        p += operations;
+    }
+    *p = 0;
+    data_set_output(&alg_hierarchy);  // supports all operations in traces
+    if (T->flags & TRACE_CHECKSUMS) {
+        value *input = malloc((TRACE_CHUNK + 1) * sizeof(value)), *out = data.output;
+        trace_rewind(T);
+        previous = 0;
+        while ((operations = trace_chunk(T, input, &previous, &checksum)) > 0) {
+            unsigned long long answers = 0;
+            for (value i = 0; i < operations; i++) {
+                answers = checksum_add(answers, *(out++));
+            }
+            assert(answers == checksum);
+        }
+        free(input);
+    }
+    trace_close(T);
+    return 1;
+}
+
+void validate_trace(const Algorithm *alg, trace *T, value *input) {
+    // Check if alg generates answers with the checksums in trace T, where 
+    // input is a buffer for TRACE_CHUNK + 1 operations
+    void *S = alg->create(T->n);
+    alg->init(S, T->n);
+    trace_rewind(T);
+    value previous = 0;
+    unsigned long long checksum;
+    while (trace_chunk(T, input, &previous, &checksum) > 0) {
+        unsigned long long answers = 0;
+        for (value *in = input; *in != 0; in++) {
+            answers = checksum_add(answers, operation(alg, S, *in));
+        }
+        assert(!(T->flags & TRACE_CHECKSUMS) || answers == checksum);
+    }
+    alg->destroy(S);
+}
+
+void trace_cache_filename(char *filename, const char *name, value n) {
+    // File in TRACE_FOLDER for test data name for n, with spaces and commas replaced
+    sprintf(filename, "%s/%s-" VALUE_FORMAT VALUE_SUFFIX ".trace", TRACE_FOLDER, name, n);
+    for (char *c = filename + strlen(TRACE_FOLDER); *c; c++) {
+        if (*c == ' ' || *c == ',') {
+            *c = '_';
+        }
+    }
+}
+
+int data_cached(const char *name, value n) {
+    // Read test data name for n from TRACE_FOLDER, if it is cached
+    char filename[300];
+    if (TRACE_FOLDER == NULL) {
+        return 0;
+    }
+    trace_cache_filename(filename, name, n);
+    return data_read(filename);
+}
+
+void data_cache() {
+    // Write the test data in data to TRACE_FOLDER
+    char filename[300];
+    if (TRACE_FOLDER == NULL) {
+        return;
+    }
+    trace_cache_filename(filename, data.name, data.n);
+    trace_write(filename, 1);
+}
+
+// ================================================================
+//   Various test input sequences
+// ================================================================
+
+void data_query_one(value n) {
+    // Create sequence Delete(1), ..., Delete(n), n x Succ(1)
+    printf("Creating Succ(1) input: n = " VALUE_FORMAT "\n", n);
+    assert(2 * n <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "query_one");
+    value *p = data.input;
+    for (value i=1; i <= n; i++, p++) {
+        *p = -i;
+    }
+    for (value i=1; i <= n; i++, p++) {
+        *p = 1;
+    }
+    *p = 0;
+    data_set_output(&alg_2pass);
+}
+
+void data_worst_case(value n, double queries_per_deletion) {
+    // Create sequence Delete(1), ..., Delete(n), interleaved with worst-case queries
+    printf("Creating worst-case input: n = " VALUE_FORMAT ", alpha = %.3f\n", n, queries_per_deletion);
+    assert(1 + n * (1 + queries_per_deletion) <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "worst_case %.3f", queries_per_deletion);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    T_init(n);
+    value queries = 0;
+    for (value i = 1; i <= n; i++) {
+        T_delete(i);
+        *(p++) = -i;
+        while (queries < i * queries_per_deletion) {
+            value j = T_deepest_node();
+            T_successor(j);
+            *(p++) = j;
+            queries += 1;
+        }
+    }
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+word *bitmap_random(value n, int k) {
+    // Create bitmap of the set {0, n + 1} and each value in {1, ..., n} 
+    // with probability 2^-k
+    value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    word *bits = malloc(n_words * sizeof(word));
+    unsigned long long state = n;
+    for (value w = 0; w < n_words; w++) {
+        bits[w] = (word) -1;
+        for (int j = 0; j < k; j++) {
+            bits[w] &= splitmix64(&state);
+        }
+    }
+    bits[0] |= 1;
+    if ((n + 2) % WORD_SIZE != 0) {
+        bits[n_words - 1] &= ((word) 1 << ((n + 2) % WORD_SIZE)) - 1;
+    }
+    bits[(n + 1) / WORD_SIZE] |= (word) 1 << ((n + 1) % WORD_SIZE);
+    return bits;
+}
+
+// Random deletions are not interleaved with path compressions, so the
+// deletions and the deepest node after each deletion are shared by the 
+// random inputs for all alpha, and are cached for the last n generated.
+// The deletions are seeded by 2n + 1, so they are reproducible and differ
+// from the random choices seeded by n in the same input
+value random_n = 0;             // n of cached random deletions, 0 = none
+value *random_deletions = NULL; // random_deletions[i] = i-th deletion
+value *random_deepest = NULL;   // random_deepest[i] = deepest node after i-th deletion
+
+void random_deletions_cache(value n) {
+    // Generate n random deletions and the deepest node after each deletion
+    if (n == random_n) {
+        return;
+    }
+    if (random_deletions == NULL) {
+        random_deletions = malloc((MAX_N + 1) * sizeof(value));
+        random_deepest = malloc((MAX_N + 1) * sizeof(value));
+    }
+    unsigned long long state = 2 * n + 1;
+    T_init(n);
+    for (value i = 1; i <= n; i++) {
+        value d = splitmix64(&state) % (n - 1) + 1;
+        T_delete(d);
+        random_deletions[i] = d;
+        random_deepest[i] = T_deepest_node();
+    }
+    random_n = n;
+}
+
+void data_random(value n, double queries_per_deletion) {
+    // Create sequence with n random Delete, interleaved with worst-case queries
+    printf("Creating random input: n = " VALUE_FORMAT ", alpha = %.3f\n", n, queries_per_deletion);
+    assert(1 + n * (1 + queries_per_deletion) <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "random %.3f", queries_per_deletion);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    random_deletions_cache(n);
+    value queries = 0;
+    for (value i = 1; i <= n; i++) {
+        *(p++) = -random_deletions[i];
+        while (queries < i * queries_per_deletion) {
+            *(p++) = random_deepest[i];
+            queries += 1;
+        }
+    }
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+void data_inserts(value n, double queries_per_deletion) {
+    // Create the sequence of data_random, where after each Delete an 
+    // earlier deletion is undone by an Insert with probability 1/2, i.e., 
+    // the sequence of data_random is the input without the Insert
+    printf("Creating random input with inserts: n = " VALUE_FORMAT ", alpha = %.3f\n", n, queries_per_deletion);
+    assert(1 + n * (1.5 + queries_per_deletion) <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "random %.3f, inserts", queries_per_deletion);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    random_deletions_cache(n);
+    unsigned long long state = n;
+    value queries = 0;
+    for (value i = 1; i <= n; i++) {
+        *(p++) = -random_deletions[i];
+        unsigned long long r = splitmix64(&state);
+        if (i > 1 && r % 2) {
+            *(p++) = random_deletions[(r >> 1) % (i - 1) + 1] | OP_INSERT;
+        }
+        while (queries < i * queries_per_deletion) {
+            *(p++) = random_deepest[i];
+            queries += 1;
+        }
+    }
+    *p = 0;
+    data_set_output(&alg_hierarchy);
+    data_cache();
+}
+
+void data_sparse(value n, double queries_per_element) {
+    // Create sequence of Delete of all but n / 16 elements of {1, ..., n}
+    // in random order, followed by alpha * n Succ of random elements
+    printf("Creating sparse input: n = " VALUE_FORMAT ", alpha = %.3f\n", n, queries_per_element);
+    assert(1 + n * (1 + queries_per_element) <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "sparse %.3f", queries_per_element);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n;
+    for (value i = 0; i < n; i++) {
+        p[i] = -(i + 1);
+    }
+    for (value i = n - 1; i > 0; i--) {  // Fisher-Yates shuffle
+        value j = splitmix64(&state) % (i + 1);
+        value t = p[i];
+        p[i] = p[j];
+        p[j] = t;
+    }
+    p += n - n / 16;
+    for (value j = 0; j < n * queries_per_element; j++) {
+        *(p++) = splitmix64(&state) % n + 1;
+    }
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+void data_mixed(value n, double queries_per_deletion) {
+    // Create sequence with n random Delete, interleaved with worst-case 
+    // queries alternating between Succ and Pred, where the deletions are
+    // those of data_random
+    printf("Creating mixed input: n = " VALUE_FORMAT ", alpha = %.3f\n", n, queries_per_deletion);
+    assert(1 + n * (1 + queries_per_deletion) <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "mixed %.3f", queries_per_deletion);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = 2 * n + 1;
+    T_init(n);
+    value queries = 0;
+    for (value i = 1; i <= n; i++) {
+        value d = splitmix64(&state) % (n - 1) + 1;
+        T_delete(d);
+        *(p++) = -d;
+        while (queries < i * queries_per_deletion) {
+            value j = T_deepest_node();
+            T_successor(j);
+            *(p++) = queries % 2 ? j | OP_PRED : j;
+            queries += 1;
+        }
+    }
+    *p = 0;
+    data_set_output(&alg_2pass_pred);
+    data_cache();
+}
+
+void data_extents(value n, value k, int elements) {
+    // Create sequence with n / k deletions of random extents of k elements,
+    // each followed by k worst-case queries, where an extent is deleted by a 
+    // single DeleteRange, or by k Delete if elements; the extents are seeded 
+    // by n and k, so both variants delete the same extents
+    printf("Creating extents input: n = " VALUE_FORMAT ", k = " VALUE_FORMAT "%s\n", n, k, elements ? ", elements" : "");
+    assert(1 + 2 * n <= MAX_OPERATIONS && 2 * k <= n);
+    data.n = n;
+    sprintf(data.name, elements ? "extents " VALUE_FORMAT ", elements" : "extents " VALUE_FORMAT, k);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n * k;
+    T_init(n);
+    for (value e = 0; e < n / k; e++) {
+        value l = splitmix64(&state) % (n - k + 1) + 1, r = l + k - 1;
+        for (value i = l; i <= r; i++) {
+            T_delete(i);
+            if (elements) {
+                *(p++) = -i;
+            }
+        }
+        if (!elements) {
+            *(p++) = -range_op(l, r);
+        }
+        for (value q = 0; q < k; q++) {
+            value j = T_deepest_node();
+            T_successor(j);
+            *(p++) = j;
+        }
+    }
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+// ================================================================
+//  Allocator-style inputs, where the set is the free slots of an
+//  allocator, and an allocation with hint x is Succ(x), i.e., the first
+//  free slot at or after x, followed by Delete of the slot found, unless
+//  there is none (n + 1). The inputs differ in the hints, and are
+//  generated by performing the allocations on a structure, seeded by n
+// ================================================================
+
+#define WINDOW_WIDTH 1024  // slots of the sliding window in data_window
+
+value zipf_hint(unsigned long long *state, value n) {
+    // Random x in {1, ..., 2^k - 1} for the max k with 2^k - 1 <= n, where 
+    // each octave [2^j, 2^(j+1)) is equally likely and x is uniform within
+    // its octave, i.e., Pr[x] is within a factor 2 of Zipf's law 1 / (k x)
+    int k = 1;
+    while (((value) 1 << (k + 1)) - 1 <= n) {
+        k++;
+    }
+    value octave = (value) 1 << (splitmix64(state) % k);
+    return octave + splitmix64(state) % octave;
+}
+
+value *allocation(value *p, const Algorithm *alg, void *S, value hint, value n) {
+    // Append an allocation with hint to p, performing it on S, and return
+    // the end of p
+    value slot = alg->successor(S, hint);
+    *(p++) = hint;
+    if (slot <= n) {
+        alg->delete(S, slot);
+        *(p++) = -slot;
+    }
+    return p;
+}
+
+void data_zipf(value n) {
+    // Create sequence of n / 2 allocations with hints from zipf_hint, i.e.,
+    // a first-fit allocator where the low slots are hot
+    printf("Creating Zipf allocation input: n = " VALUE_FORMAT "\n", n);
+    assert(1 + 2 * n <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "zipf");
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n;
+    void *S = alg_2pass.create(n);
+    alg_2pass.init(S, n);
+    for (value i = 0; i < n / 2; i++) {
+        p = allocation(p, &alg_2pass, S, zipf_hint(&state, n), n);
+    }
+    alg_2pass.destroy(S);
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+void data_frontier(value n) {
+    // Create sequence of n next-fit allocations, each hinted by the slot 
+    // after the previous allocation, i.e., a frontier sweeping the slots 
+    // and restarting at 1 after n, where each allocation is preceded by a
+    // random Delete, i.e., a slot allocated elsewhere
+    printf("Creating frontier allocation input: n = " VALUE_FORMAT "\n", n);
+    assert(1 + 3 * n <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "frontier");
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n;
+    void *S = alg_2pass.create(n);
+    alg_2pass.init(S, n);
+    value frontier = 1;
+    for (value i = 0; i < n; i++) {
+        value d = splitmix64(&state) % n + 1;
+        alg_2pass.delete(S, d);
+        *(p++) = -d;
+        p = allocation(p, &alg_2pass, S, frontier, n);
+        frontier = p[-1] < 0 ? -p[-1] % n + 1 : 1;
+    }
+    alg_2pass.destroy(S);
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+void data_window(value n) {
+    // Create sequence of n allocations with hints uniform in a window of
+    // WINDOW_WIDTH slots, sliding from the start to the end of the slots,
+    // i.e., allocations that are clustered in space and time
+    value w = WINDOW_WIDTH < n ? WINDOW_WIDTH : n;
+    printf("Creating window allocation input: n = " VALUE_FORMAT ", width = " VALUE_FORMAT "\n", n, w);
+    assert(1 + 2 * n <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "window %d", WINDOW_WIDTH);
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n;
+    void *S = alg_2pass.create(n);
+    alg_2pass.init(S, n);
+    for (value i = 0; i < n; i++) {
+        value start = 1 + (long long) i * (n - w) / n;
+        p = allocation(p, &alg_2pass, S, start + splitmix64(&state) % w, n);
+    }
+    alg_2pass.destroy(S);
+    *p = 0;
+    data_set_output(&alg_2pass);
+    data_cache();
+}
+
+void data_lifo(value n) {
+    // Create sequence of 2n steps, where a step with probability 1/2 frees
+    // the most recent allocation not yet freed by an Insert, and otherwise
+    // is an allocation with a hint from zipf_hint, i.e., allocations freed
+    // in LIFO order as by a stack allocator
+    printf("Creating LIFO allocation input: n = " VALUE_FORMAT "\n", n);
+    assert(1 + 4 * n <= MAX_OPERATIONS);
+    data.n = n;
+    sprintf(data.name, "lifo");
+    if (data_cached(data.name, n)) {
+        return;
+    }
+    value *p = data.input;
+    unsigned long long state = n;
+    value *stack = malloc(2 * n * sizeof(value)), top = 0;
+    void *S = alg_hierarchy.create(n);
+    alg_hierarchy.init(S, n);
+    for (value i = 0; i < 2 * n; i++) {
+        if (top > 0 && splitmix64(&state) % 2) {
+            alg_hierarchy.insert(S, stack[--top]);
+            *(p++) = stack[top] | OP_INSERT;
+            continue;
+        }
+        p = allocation(p, &alg_hierarchy, S, zipf_hint(&state, n), n);
+        if (p[-1] < 0) {
+            stack[top++] = -p[-1];
+        }
+    }
+    alg_hierarchy.destroy(S);
+    free(stack);
+    *p = 0;
+    data_set_output(&alg_hierarchy);
+    data_cache();
+}
+
+// ================================================================
+//  Streamed test data for n beyond MAX_N, where the 9n operations of
+//  data.input would not fit in memory. The operations are generated in
+//  chunks of TRACE_CHUNK operations from a seed, so the same operations
+//  are replayed for each run and algorithm without being stored. The 
+//  queries are random, since the worst-case queries are found by 
+//  simulating the deletions in T, which needs more memory than the
+//  structures evaluated
+// ================================================================
+
+typedef struct {
+    value n;                      // initial set size {1,...,n}
+    double queries_per_deletion;  // alpha
+    unsigned long long state;     // splitmix64 state, seeded by n
+    value deletions;              // deletions generated
+    value queries;                // queries generated
+} stream;
+
+void stream_rewind(stream *D) {
+    D->state = D->n;
+    D->deletions = 0;
+    D->queries = 0;
+}
+
+value stream_chunk(stream *D, value *input) {
+    // Generate the next at most TRACE_CHUNK operations of n random Delete,
+    // where the i-th Delete is followed by Succ(random) until there have 
+    // been i * alpha queries, ending input with 0, and return the number 
+    // of operations generated
+    value *p = input;
+    while (p - input < TRACE_CHUNK) {
+        if (D->queries < D->deletions * D->queries_per_deletion) {
+            *(p++) = splitmix64(&D->state) % D->n + 1;
+            D->queries++;
+        } else if (D->deletions < D->n) {
+            *(p++) = -(value) (splitmix64(&D->state) % (D->n - 1) + 1);
+            D->deletions++;
+        } else {
+            break;
+        }
+    }
+    *p = 0;
+    return p - input;
+}
+
+// ================================================================
+//  List of algorithms evaluated
+// ================================================================
+
+const int n_algorithms = 30;
+const Algorithm algorithms[30] = {
+    alg_naive, 
+    alg_recursive, 
+    alg_2pass, 
+    alg_2pass_checked, 
+    alg_halving, 
+    alg_halving_checked,
+    alg_2pass_bounded,
+    alg_2pass_sampled,
+    alg_quick_find, 
+    alg_union_find,
+    alg_qf_microset,
+    alg_uf_microset,
+    alg_ds_microset,
+    alg_hierarchy,
+    alg_2pass_pred,
+    alg_union_find_pred,
+    alg_uf_pred_microset,
+    alg_ds_pred_microset,
+    alg_2pass_concurrent,
+    alg_halving_concurrent,
+    alg_blocked,
+    alg_ds_microset2,
+    alg_quick_find_compact,
+    alg_union_find_compact,
+    alg_cqf_microset,
+    alg_cuf_microset,
+    alg_snapshot,
+    alg_2pass_sharded,
+    alg_ds_microset_sharded,
+    alg_adaptive
+};
+
+// ================================================================
+//   Selection of tests
+//
+//   The tests can be restricted to a subset of the algorithms, a range
+//   of n, and a set of alpha values (queries per deletion in the
+//   worst-case, random and mixed tests). When resuming an interrupted
+//   run, rows already in DATAFILE are not timed again, where a row is
+//   identified by the algorithm, the input and n.
+// ================================================================
+
+int skip_algorithm[30];          // skip_algorithm[s] = algorithms[s] not selected
+value FROM_N = 0, TO_N = 0;      // only tests with FROM_N <= n <= TO_N, 0 = no bound
+int RESUME = 0;                  // skip rows already in DATAFILE, option -r
+#define MAX_ALPHAS 16
+double alphas[MAX_ALPHAS];       // only tests with these alphas, none = all
+int n_alphas = 0;
+char **done_rows = NULL;         // sorted rows in DATAFILE when resuming, see resume
+value n_done_rows = 0;
+
+int selected_n(value n) {
+    return (FROM_N == 0 || n >= FROM_N) && (TO_N == 0 || n <= TO_N);
+}
+
+int selected_alpha(double q) {
+    if (n_alphas == 0) {
+        return 1;
+    }
+    for (int a = 0; a < n_alphas; a++) {
+        if (alphas[a] == q) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int compare_rows(const void *a, const void *b) {
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+int compare_row_prefix(const void *key, const void *row) {
+    return strncmp(key, *(char * const *) row, strlen(key));
+}
+
+int skip_row(const Algorithm *alg, const char *variant, const char *input, value n) {
+    // Test if the row for alg with variant appended to its name on input is
+    // not to be timed, since alg is not selected, does not support n, or
+    // the row is already done
+    if (alg >= algorithms && alg < algorithms + n_algorithms && skip_algorithm[alg - algorithms]) {
+        return 1;
+    }
+    if (alg->max_n != 0 && n > alg->max_n) {
+        return 1;
+    }
+    char key[1000];
+    snprintf(key, sizeof(key), "\"%s%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, variant, ROW_SUFFIX, input, n);
+    return n_done_rows > 0 && bsearch(key, done_rows, n_done_rows, sizeof(char *), compare_row_prefix) != NULL;
+}
+
+// ================================================================
+//  Timing functions
+// ================================================================
+
+value trash = 0;  // xor of all successor results, avoid compiler optimization
+
+double wall_time() {
+    // Monotonic wall clock time in seconds
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// Measurements of timings, where each measurement records monotonic wall
+// time in nanoseconds, time stamp counter ticks if compiled with 
+// -DUSE_RDTSC on x86, and on Linux the hardware counters below if
+// perf_event_open permits it (see /proc/sys/kernel/perf_event_paranoid)
+
+#define N_COUNTERS 4
+const char *counter_names[N_COUNTERS] = {"instructions", "cache_misses", "dtlb_misses", "branch_misses"};
+int counter_fds[N_COUNTERS];
+int counters_opened = 0;
+
+typedef struct {
+    long long start_ns, start_tsc, start_counters[N_COUNTERS];
+    double seconds;               // wall time since start
+    double tsc;                   // time stamp counter ticks since start, or -1
+    double counters[N_COUNTERS];  // hardware events since start, or -1
+    double bytes;                 // bytes allocated by the structure, or 0 if not recorded, see record_counts
+    double links, writes, dirty;  // count_links, count_writes and count_dirty of the queries in a run, if COUNTS
+} measurement;
+
+void counters_open() {
+    // Open the hardware counters for this thread, unavailable counters are -1
+    if (counters_opened) return;
+    counters_opened = 1;
+    for (int c = 0; c < N_COUNTERS; c++) {
+        counter_fds[c] = -1;
+    }
+#ifdef __linux__
+    const unsigned int type[N_COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const unsigned long long config[N_COUNTERS] = {
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int c = 0; c < N_COUNTERS; c++) {
+        struct perf_event_attr attr = {0};
+        attr.size = sizeof(attr);
+        attr.type = type[c];
+        attr.config = config[c];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counter_fds[c] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+long long counter_read(int c) {
+    long long count;
+    if (counter_fds[c] < 0 || read(counter_fds[c], &count, sizeof(count)) != sizeof(count)) {
+        return -1;
+    }
+    return count;
+}
+
+long long tsc_read() {
+#if defined(USE_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return -1;
+#endif
+}
+
+long long wall_time_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+void measure_start(measurement *m) {
+    // Start the measurements, where bytes, links, writes and dirty are not
+    // recorded unless set by record_counts
+    m->bytes = m->links = m->writes = m->dirty = 0;
+    counters_open();
+    for (int c = 0; c < N_COUNTERS; c++) {
+        m->start_counters[c] = counter_read(c);
+    }
+    m->start_tsc = tsc_read();
+    m->start_ns = wall_time_ns();
+}
+
+void measure_stop(measurement *m) {
+    // Record the measurements since measure_start, can be called repeatedly
+    m->seconds = 1e-9 * (wall_time_ns() - m->start_ns);
+    m->tsc = m->start_tsc < 0 ? -1 : tsc_read() - m->start_tsc;
+    for (int c = 0; c < N_COUNTERS; c++) {
+        long long count = m->start_counters[c] < 0 ? -1 : counter_read(c);
+        m->counters[c] = count < 0 ? -1 : count - m->start_counters[c];
+    }
+}
+
+void measure_scale(measurement *m, double runs) {
+    // Make a measurement of several runs into a measurement of a single run
+    m->seconds /= runs;
+    if (m->tsc >= 0) m->tsc /= runs;
+    for (int c = 0; c < N_COUNTERS; c++) {
+        if (m->counters[c] >= 0) m->counters[c] /= runs;
+    }
+}
+
+void print_measurement(FILE *f, const measurement *m) {
+    // Print time, and available counters as a Python dictionary column
+    fprintf(f, "%.10e", m->seconds);
+    int columns = 0;
+    if (m->tsc >= 0) {
+        fprintf(f, ", {\"tsc\": %.4e", m->tsc);
+        columns++;
+    }
+    for (int c = 0; c < N_COUNTERS; c++) {
+        if (m->counters[c] >= 0) {
+            fprintf(f, "%s\"%s\": %.4e", columns++ ? ", " : ", {", counter_names[c], m->counters[c]);
+        }
+    }
+    if (m->bytes > 0) {
+        fprintf(f, "%s\"bytes\": %.4e", columns++ ? ", " : ", {", m->bytes);
+        if (COUNTS) {
+            fprintf(f, ", \"links\": %.4e, \"writes\": %.4e, \"dirty\": %.4e", m->links, m->writes, m->dirty);
+        }
+    }
+    fprintf(f, columns ? "}\n" : "\n");
+}
+
+void record_counts(const Algorithm *alg, measurement *m) {
+    // Record in m the bytes allocated by alg->create(n) and alg->init(n), 
+    // i.e., the footprint of the structure for sets of size n, and if 
+    // COUNTS, the links, writes and dirty lines of the successor queries while 
+    // performing the operations in data.input
+    size_t allocated = memory_allocated;
+    void *S = alg->create(data.n);
+    alg->init(S, data.n);
+    m->bytes = memory_allocated - allocated;
+    m->links = m->writes = m->dirty = 0;
+    for (value *in = data.input; COUNTS && *in != 0; in++) {
+        unsigned long long links = count_links, writes = count_writes, dirty = count_dirty;
+        count_line = 0;  // lines dirtied by the previous query count again
+        trash ^= operation(alg, S, *in);
+        if (*in > 0 && !(*in & (OP_PRED | OP_INSERT))) {
+            m->links += count_links - links;
+            m->writes += count_writes - writes;
+            m->dirty += count_dirty - dirty;
+        }
+    }
+    alg->destroy(S);
+}
+
+void time_it(const Algorithm *alg, const char *data_filename) {
+    // Time the algorithm alg on the test data in data.input
+    if (skip_row(alg, "", data.name, data.n)) {
+        return;
+    }
+    validate(alg);  // check if algorithm generates correct output before timing
+
+    void (*init)(void *, value)       = alg->init;
+    void (*delete)(void *, value)     = alg->delete;
+    value (*successor)(void *, value) = alg->successor;
+    value n                           = data.n;
+    value *input                      = data.input;
+    void *S                           = alg->create(n);
+
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                init(S, n);
+                if (data.extended) {
+                    for (value *in = input; *in != 0; in++) {
+                        trash ^= operation(alg, S, *in);
+                    }
+                    continue;
+                }
+                for (value *in = input; *in != 0; in++) {
+                    value x = *in;
+                    if (x >= 0) {
+                        trash ^= successor(S, x);
+                    } else {
+                        delete(S, -x);
+                    }
+                }
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, r - first);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    alg->destroy(S);
+    record_counts(alg, &best);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+void time_it_replay(const Algorithm *alg, const char *data_filename) {
+    // Time the algorithm alg on the test data in data.input using its 
+    // replay, i.e., without the calls through function pointers of time_it
+    if (skip_row(alg, ", replay", data.name, data.n)) {
+        return;
+    }
+    assert(!data.extended);
+    validate(alg);
+    value n = data.n;
+    void *S = alg->create(n);
+    value answers = 0;
+    for (value *in = data.input, *out = data.output; *in != 0; in++, out++) {
+        answers ^= *out;
+    }
+    alg->init(S, n);
+    assert(alg->replay(S, data.input) == answers);
+
+    printf("\"%s, replay%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                alg->init(S, n);
+                trash ^= alg->replay(S, data.input);
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, r - first);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    alg->destroy(S);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s, replay%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+// HDR-style histograms of latencies in picoseconds, where each power of two
+// range [2^e, 2^(e+1)) is split into 2^HISTOGRAM_SUB_BITS buckets, i.e., 
+// latencies are recorded with relative error less than 2^-HISTOGRAM_SUB_BITS
+
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_BUCKETS (64 << HISTOGRAM_SUB_BITS)
+
+typedef struct {
+    long long count[HISTOGRAM_BUCKETS];
+    long long total;     // number of latencies recorded
+    double sum;          // sum of latencies recorded
+} histogram;
+
+int histogram_bucket(unsigned long long v) {
+    if (v < (1 << HISTOGRAM_SUB_BITS)) {
+        return v;
+    }
+    int e = 63 - __builtin_clzll(v);  // 2^e <= v < 2^(e+1)
+    return ((e - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) + ((v >> (e - HISTOGRAM_SUB_BITS)) & ((1 << HISTOGRAM_SUB_BITS) - 1));
+}
+
+unsigned long long histogram_bucket_value(int b) {
+    // Smallest latency in bucket b
+    int g = b >> HISTOGRAM_SUB_BITS, sub = b & ((1 << HISTOGRAM_SUB_BITS) - 1);
+    return g == 0 ? sub : (unsigned long long) ((1 << HISTOGRAM_SUB_BITS) + sub) << (g - 1);
+}
+
+void histogram_record(histogram *h, unsigned long long v, long long count) {
+    h->count[histogram_bucket(v)] += count;
+    h->total += count;
+    h->sum += (double) v * count;
+}
+
+double histogram_percentile(const histogram *h, double p) {
+    // Smallest latency in the bucket containing the p-th percentile, in seconds
+    long long rank = (long long) (p / 100 * h->total), seen = 0;
+    if (rank >= h->total) {
+        rank = h->total - 1;
+    }
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        seen += h->count[b];
+        if (seen > rank) {
+            return 1e-12 * histogram_bucket_value(b);
+        }
+    }
+    return 0;
+}
+
+void print_histogram(FILE *f, const histogram *h) {
+    // Print mean latency, and percentiles as a Python dictionary column
+    fprintf(f, "%.10e, {\"p50\": %.4e, \"p99\": %.4e, \"p99.9\": %.4e, \"max\": %.4e}\n", 
+            h->total ? 1e-12 * h->sum / h->total : 0.0, histogram_percentile(h, 50), 
+            histogram_percentile(h, 99), histogram_percentile(h, 99.9), histogram_percentile(h, 100));
+}
+
+long long latency_overhead_ns() {
+    // Minimal time between two calls to the clock, subtracted from latencies
+    long long overhead = 1LL << 62;
+    for (int i = 0; i < 1000; i++) {
+        long long t0 = wall_time_ns(), t1 = wall_time_ns();
+        if (t1 - t0 < overhead) {
+            overhead = t1 - t0;
+        }
+    }
+    return overhead;
+}
+
+void time_latency(const Algorithm *alg, const char *data_filename) {
+    // Record histograms of the latencies of successor and delete operations
+    // on the test data in data.input, where runs of up to LATENCY_BATCH 
+    // operations of the same kind are timed together, and each operation in 
+    // a run is recorded with the average latency of the run
+    const char *kinds[2] = {"successor", "delete"};
+    char inputs[2][300];
+    for (int kind = 0; kind < 2; kind++) {
+        snprintf(inputs[kind], sizeof(inputs[kind]), "%s, %s latency", data.name, kinds[kind]);
+    }
+    if (skip_row(alg, "", inputs[0], data.n) && skip_row(alg, "", inputs[1], data.n)) {
+        return;
+    }
+    validate(alg);
+    static histogram h[2];  // h[0] = successor, h[1] = delete
+    h[0] = h[1] = (histogram) {0};
+    long long overhead = latency_overhead_ns();
+    value n = data.n;
+    void *S = alg->create(n);
+    double seconds = 0;
+    for (int r = 0; r < MIN_REPEATS || seconds < MIN_TEST_TIME; r++) {
+        long long start = wall_time_ns();
+        alg->init(S, n);
+        for (value *in = data.input; *in != 0; ) {
+            int kind = *in < 0;
+            int k = 0;
+            long long t0 = wall_time_ns();
+            for (; k < LATENCY_BATCH && *in != 0 && (*in < 0) == kind; in++, k++) {
+                trash ^= operation(alg, S, *in);
+            }
+            long long ns = wall_time_ns() - t0 - overhead;
+            histogram_record(&h[kind], ns < 0 ? 0 : 1000 * ns / k, k);
+        }
+        seconds += 1e-9 * (wall_time_ns() - start);
+    }
+    alg->destroy(S);
+    for (int kind = 0; kind < 2; kind++) {
+        printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, inputs[kind], n);
+        print_histogram(stdout, &h[kind]);
+        FILE *data_file = fopen(data_filename, "a");
+        fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, inputs[kind], n);
+        print_histogram(data_file, &h[kind]);
+        fclose(data_file);
+    }
+}
+
+void time_it_trace(const Algorithm *alg, const char *filename, const char *data_filename) {
+    // Time the algorithm alg on the trace in filename, streaming the trace
+    // in chunks, where only the operations are timed and not the decoding
+    trace *T = trace_open(filename);
+    assert(T != NULL);
+    char name[300];
+    snprintf(name, sizeof(name), "%s, trace", T->name);
+    if (skip_row(alg, "", name, T->n)) {
+        trace_close(T);
+        return;
+    }
+    value *input = malloc((TRACE_CHUNK + 1) * sizeof(value));
+    validate_trace(alg, T, input);
+    value n = T->n;
+    void *S = alg->create(n);
+
+    printf("\"%s%s\", \"%s, trace\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, T->name, n);
+    fflush(stdout);
+    double best_time = 1e100;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        double seconds = 0;
+        int r = 0;
+        for (; r < MIN_REPEATS || seconds < MIN_TEST_TIME; r++) {
+            trace_rewind(T);
+            value previous = 0;
+            unsigned long long checksum;
+            long long start = wall_time_ns();
+            alg->init(S, n);
+            while (1) {
+                seconds += 1e-9 * (wall_time_ns() - start);
+                if (trace_chunk(T, input, &previous, &checksum) == 0) {
+                    break;
+                }
+                start = wall_time_ns();
+                for (value *in = input; *in != 0; in++) {
+                    trash ^= operation(alg, S, *in);
+                }
+            }
+        }
+        seconds /= r;
+        if (seconds < best_time) {
+            best_time = seconds;
+        }
+    }
+    alg->destroy(S);
+    free(input);
+    printf("%.10e\n", best_time);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s, trace\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, T->name, n, best_time);
+    fclose(data_file);
+    trace_close(T);
+}
+
+#define STREAM_VALIDATE_N (1 << 12)  // set size of the stream validated against alg_2pass
+
+void validate_stream(const Algorithm *alg, double queries_per_deletion, value *input) {
+    // Check if alg generates the same answers as alg_2pass on the stream 
+    // for n = STREAM_VALIDATE_N, where input is a buffer for TRACE_CHUNK + 1
+    // operations
+    stream D = {STREAM_VALIDATE_N, queries_per_deletion};
+    stream_rewind(&D);
+    void *S = alg->create(D.n), *R = alg_2pass.create(D.n);
+    alg->init(S, D.n);
+    alg_2pass.init(R, D.n);
+    while (stream_chunk(&D, input) > 0) {
+        for (value *in = input; *in != 0; in++) {
+            assert(operation(alg, S, *in) == operation(&alg_2pass, R, *in));
+        }
+    }
+    alg->destroy(S);
+    alg_2pass.destroy(R);
+}
+
+// Checksum of the answers of the first algorithm timed on the stream for
+// stream_checksum_n, which the other algorithms must reproduce
+value stream_checksum_n = 0;
+double stream_checksum_q;
+unsigned long long stream_checksum;
+
+void time_it_stream(const Algorithm *alg, value n, double queries_per_deletion, const char *data_filename) {
+    // Time the algorithm alg on the stream for n and alpha, where only the
+    // operations are timed and not the generation. Since one run takes
+    // minutes for the largest n, the runs are budgeted by time: a timing
+    // repeats the run until MIN_TEST_TIME, but at least once, and the best
+    // of BEST_OF timings is only taken while the timings so far took less
+    // than BEST_OF * MIN_TEST_TIME
+    char name[100];
+    snprintf(name, sizeof(name), "stream %.3f", queries_per_deletion);
+    if (skip_row(alg, "", name, n)) {
+        return;
+    }
+    value *input = malloc((TRACE_CHUNK + 1) * sizeof(value));
+    validate_stream(alg, queries_per_deletion, input);
+    stream D = {n, queries_per_deletion};
+    void *S = alg->create(n);
+
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, name, n);
+    fflush(stdout);
+    double best_time = 1e100, total = 0;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF && total < BEST_OF * MIN_TEST_TIME; repeat_timing++) {
+        double seconds = 0;
+        int r = 0;
+        for (; r == 0 || seconds < MIN_TEST_TIME; r++) {
+            stream_rewind(&D);
+            unsigned long long checksum = 0;
+            long long start = wall_time_ns();
+            alg->init(S, n);
+            while (1) {
+                seconds += 1e-9 * (wall_time_ns() - start);
+                if (stream_chunk(&D, input) == 0) {
+                    break;
+                }
+                start = wall_time_ns();
+                for (value *in = input; *in != 0; in++) {
+                    checksum = checksum_add(checksum, operation(alg, S, *in));
+                }
+            }
+            if (stream_checksum_n != n || stream_checksum_q != queries_per_deletion) {
+                stream_checksum_n = n;
+                stream_checksum_q = queries_per_deletion;
+                stream_checksum = checksum;
+            }
+            assert(checksum == stream_checksum);
+        }
+        total += seconds;
+        seconds /= r;
+        if (seconds < best_time) {
+            best_time = seconds;
+        }
+    }
+    alg->destroy(S);
+    free(input);
+    printf("%.10e\n", best_time);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, name, n, best_time);
+    fclose(data_file);
+}
+
+void time_it_batched(const Algorithm *alg, int sorted, const char *data_filename) {
+    // Time the algorithm alg on the test data in data.input, where runs of
+    // successor queries and deletions are performed as batches, and the 
+    // queries in a batch are sorted if sorted
+    const char *variant = sorted ? ", sorted batched" : ", batched";
+    if (skip_row(alg, variant, data.name, data.n)) {
+        return;
+    }
+    validate_batched(alg, sorted);
+
+    value *elements, *runs, out[BATCH_SIZE];
+    batch_input(&elements, &runs, sorted);
+    value n = data.n;
+    void *S = alg->create(n);
+
+    printf("\"%s%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, variant, ROW_SUFFIX, data.name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                alg->init(S, n);
+                value *e = elements;
+                for (value *run = runs; *run != 0; run++) {
+                    if (*run > 0) {
+                        if (sorted) {
+                            batch_successor_sorted(alg, S, e, out, *run);
+                        } else {
+                            batch_successor(alg, S, e, out, *run);
+                        }
+                        for (value j = 0; j < *run; j++) {
+                            trash ^= out[j];
+                        }
+                        e += *run;
+                    } else {
+                        batch_delete(alg, S, e, -*run);
+                        e -= *run;
+                    }
+                }
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, r - first);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    alg->destroy(S);
+    free(elements);
+    free(runs);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, variant, ROW_SUFFIX, data.name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+void ring_reap(successor_ring *R, int check) {
+    // Reap all completed queries, and if check, assert that the answers are
+    // data.output, otherwise xor them into trash
+    ring_entry c[BATCH_SIZE];
+    for (size_t k; (k = ring_complete(R, c, BATCH_SIZE)) > 0; ) {
+        for (size_t j = 0; j < k; j++) {
+            if (check) {
+                assert(c[j].x == data.output[c[j].tag]);
+            } else {
+                trash ^= c[j].x;
+            }
+        }
+    }
+}
+
+void ring_run(successor_ring *R, int check) {
+    // Perform the operations in data.input on R, where the queries are
+    // submitted tagged by their position in data.input, and each deletion
+    // waits for the submitted queries, see ring_reap for check
+    for (value *in = data.input; *in != 0; in++) {
+        if (*in > 0) {
+            while (!ring_submit(R, *in, in - data.input)) {
+                ring_poll(R);
+                ring_reap(R, check);
+            }
+        } else {
+            ring_drain(R);
+            ring_reap(R, check);
+            R->alg->delete(R->S, -*in);
+        }
+    }
+    ring_drain(R);
+    ring_reap(R, check);
+}
+
+void validate_ring(const Algorithm *alg) {
+    // Check if the answers to the queries submitted to a ring are correct
+    assert(!data.extended);
+    static successor_ring R;
+    void *S = alg->create(data.n);
+    alg->init(S, data.n);
+    ring_init(&R, alg, S);
+    ring_run(&R, 1);
+    alg->destroy(S);
+}
+
+void time_it_ring(const Algorithm *alg, const char *data_filename) {
+    // Time the algorithm alg on the test data in data.input, where the 
+    // queries are submitted to a successor_ring, see ring_run
+    if (skip_row(alg, ", ring", data.name, data.n)) {
+        return;
+    }
+    validate_ring(alg);
+
+    static successor_ring R;
+    value n = data.n;
+    void *S = alg->create(n);
+
+    printf("\"%s, ring%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                alg->init(S, n);
+                ring_init(&R, alg, S);
+                ring_run(&R, 0);
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, r - first);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    alg->destroy(S);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s, ring%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+void validate_range(const Algorithm *alg, size_t k) {
+    // Check the range queries of alg against range queries by repeated 
+    // successor queries on a 2-pass structure
+    assert(!data.extended && k <= BATCH_SIZE);
+    value n = data.n, out[BATCH_SIZE], expected[BATCH_SIZE];
+    void *S = alg->create(n);
+    void *R = alg_2pass.create(n);
+    alg->init(S, n);
+    alg_2pass.init(R, n);
+    for (value *in = data.input; *in != 0; in++) {
+        if (*in >= 0) {
+            batch_range(alg, S, n, *in, out, k);
+            batch_range(&alg_2pass, R, n, *in, expected, k);
+            assert(memcmp(out, expected, k * sizeof(value)) == 0);
+        } else {
+            alg->delete(S, -*in);
+            alg_2pass.delete(R, -*in);
+        }
+    }
+    alg->destroy(S);
+    alg_2pass.destroy(R);
+}
+
+void time_it_range(const Algorithm *alg, size_t k, const char *data_filename) {
+    // Time the algorithm alg on the test data in data.input, where each 
+    // successor query is a range query for the next k elements
+    char name[300];
+    snprintf(name, sizeof(name), "%s, range %zu", data.name, k);
+    if (skip_row(alg, "", name, data.n)) {
+        return;
+    }
+    validate_range(alg, k);
+
+    value n = data.n, out[BATCH_SIZE];
+    void *S = alg->create(n);
+
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                alg->init(S, n);
+                for (value *in = data.input; *in != 0; in++) {
+                    if (*in >= 0) {
+                        batch_range(alg, S, n, *in, out, k);
+                        trash ^= out[k - 1];
+                    } else {
+                        alg->delete(S, -*in);
+                    }
+                }
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, r - first);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    alg->destroy(S);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+typedef struct {
+    const Algorithm *alg;
+    void *S;                    // structure shared by all threads
+    const value *begin, *end;   // operations performed by the thread
+    pthread_barrier_t *start;   // all threads start when main thread is ready
+    value trash;
+} thread_task;
+
+void *thread_run(void *arg) {
+    thread_task *task = arg;
+    value (*successor)(void *, value) = task->alg->successor;
+    void (*delete)(void *, value)     = task->alg->delete;
+    void *S                           = task->S;
+    value trash                       = 0;
+    pthread_barrier_wait(task->start);
+    for (const value *in = task->begin; in < task->end; in++) {
+        value x = *in;
+        if (x >= 0) {
+            trash ^= successor(S, x);
+        } else {
+            delete(S, -x);
+        }
+    }
+    task->trash = trash;
+    return NULL;
+}
+
+double run_threads(const Algorithm *alg, void *S, int threads) {
+    // Perform data.input on S partitioned into consecutive parts of equal 
+    // size among threads, and return the wall time used
+    value m = 0;
+    while (data.input[m] != 0) {
+        m++;
+    }
+    pthread_t thread[MAX_THREADS];
+    thread_task task[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (int t = 0; t < threads; t++) {
+        task[t] = (thread_task) {alg, S, data.input + (long long) m * t / threads, data.input + (long long) m * (t + 1) / threads, &start, 0};
+        pthread_create(&thread[t], NULL, thread_run, &task[t]);
+    }
+    pthread_barrier_wait(&start);
+    double start_time = wall_time();
+    for (int t = 0; t < threads; t++) {
+        pthread_join(thread[t], NULL);
+        trash ^= task[t].trash;
+    }
+    double end_time = wall_time();
+    pthread_barrier_destroy(&start);
+    return end_time - start_time;
+}
+
+void validate_threads(const Algorithm *alg, int threads) {
+    // Check if the set after performing data.input concurrently is correct,
+    // using that the resulting set is independent of the order of deletions 
+    validate(alg);
+    value n = data.n;
+    void *S = alg->create(n);
+    void *R = alg_2pass.create(n);
+    alg->init(S, n);
+    alg_2pass.init(R, n);
+    run_threads(alg, S, threads);
+    for (value *in = data.input; *in != 0; in++) {
+        if (*in < 0) {
+            alg_2pass.delete(R, -*in);
+        }
+    }
+    for (value i = 0; i < n + 2; i++) {
+        assert(alg->successor(S, i) == alg_2pass.successor(R, i));
+    }
+    alg->destroy(S);
+    alg_2pass.destroy(R);
+}
+
+void time_it_threads(const Algorithm *alg, int threads, const char *data_filename) {
+    // Time the concurrent algorithm alg on the test data in data.input,
+    // where the operations are partitioned among threads
+    assert(alg->concurrent && !data.extended && threads <= MAX_THREADS);
+    char name[300];
+    snprintf(name, sizeof(name), "%s, %d threads", data.name, threads);
+    if (skip_row(alg, "", name, data.n)) {
+        return;
+    }
+    validate_threads(alg, threads);
+
+    value n = data.n;
+    void *S = alg->create(n);
+
+    printf("\"%s%s\", \"%s, %d threads\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, threads, n);
+    fflush(stdout);
+    double best_time = 1e100;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        double seconds = 0;
+        int r = 0;
+        while (r < MIN_REPEATS || seconds < MIN_TEST_TIME) {
+            alg->init(S, n);
+            seconds += run_threads(alg, S, threads);
+            r++;
+        }
+        seconds /= r;
+        if (seconds < best_time) {
+            best_time = seconds;
+        }
+    }
+    alg->destroy(S);
+    printf("%.10e\n", best_time);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s, %d threads\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, data.name, threads, n, best_time);
+    fclose(data_file);
+}
+
+void *reader_run(void *arg) {
+    // The successor queries in the part of a reader, in the published 
+    // snapshot if the algorithm has snapshots
+    thread_task *task = arg;
+    value (*successor)(void *, value) = task->alg->snapshot_successor ? task->alg->snapshot_successor : task->alg->successor;
+    void *S = task->S;
+    value trash = 0;
+    pthread_barrier_wait(task->start);
+    for (const value *in = task->begin; in < task->end; in++) {
+        if (*in >= 0) {
+            trash ^= successor(S, *in);
+        }
+    }
+    task->trash = trash;
+    return NULL;
+}
+
+void *writer_run(void *arg) {
+    // All deletions in data.input, finally published if the algorithm has snapshots
+    thread_task *task = arg;
+    void (*delete)(void *, value) = task->alg->delete;
+    void *S = task->S;
+    pthread_barrier_wait(task->start);
+    for (const value *in = task->begin; in < task->end; in++) {
+        if (*in < 0) {
+            delete(S, -*in);
+        }
+    }
+    if (task->alg->publish) {
+        task->alg->publish(S);
+    }
+    return NULL;
+}
+
+double run_readers(const Algorithm *alg, void *S, int readers) {
+    // Perform the deletions of data.input by a single writer thread and the
+    // queries of data.input partitioned into consecutive parts of equal size 
+    // among readers, and return the wall time used
+    value m = 0;
+    while (data.input[m] != 0) {
+        m++;
+    }
+    pthread_t thread[MAX_THREADS];
+    thread_task task[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, readers + 2);
+    for (int t = 0; t < readers; t++) {
+        task[t] = (thread_task) {alg, S, data.input + (long long) m * t / readers, data.input + (long long) m * (t + 1) / readers, &start, 0};
+        pthread_create(&thread[t], NULL, reader_run, &task[t]);
+    }
+    task[readers] = (thread_task) {alg, S, data.input, data.input + m, &start, 0};
+    pthread_create(&thread[readers], NULL, writer_run, &task[readers]);
+    pthread_barrier_wait(&start);
+    double start_time = wall_time();
+    for (int t = 0; t <= readers; t++) {
+        pthread_join(thread[t], NULL);
+        trash ^= task[t].trash;
+    }
+    double end_time = wall_time();
+    pthread_barrier_destroy(&start);
+    return end_time - start_time;
+}
+
+void validate_readers(const Algorithm *alg, int readers) {
+    // Check if the set seen by readers after the writer is done is correct
+    validate(alg);
+    value n = data.n;
+    void *S = alg->create(n);
+    void *R = alg_2pass.create(n);
+    alg->init(S, n);
+    alg_2pass.init(R, n);
+    run_readers(alg, S, readers);
+    for (value *in = data.input; *in != 0; in++) {
+        if (*in < 0) {
+            alg_2pass.delete(R, -*in);
+        }
+    }
+    value (*successor)(void *, value) = alg->snapshot_successor ? alg->snapshot_successor : alg->successor;
+    for (value i = 0; i < n + 2; i++) {
+        assert(successor(S, i) == alg_2pass.successor(R, i));
+    }
+    alg->destroy(S);
+    alg_2pass.destroy(R);
+}
+
+void time_it_readers(const Algorithm *alg, int readers, const char *data_filename) {
+    // Time the concurrent or snapshot algorithm alg on the test data in 
+    // data.input, with a single writer and the queries partitioned among readers
+    assert((alg->concurrent || alg->snapshot_successor) && !data.extended && readers < MAX_THREADS);
+    char name[300];
+    snprintf(name, sizeof(name), "%s, %d readers", data.name, readers);
+    if (skip_row(alg, "", name, data.n)) {
+        return;
+    }
+    validate_readers(alg, readers);
+
+    value n = data.n;
+    void *S = alg->create(n);
+
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, name, n);
+    fflush(stdout);
+    double best_time = 1e100;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        double seconds = 0;
+        int r = 0;
+        while (r < MIN_REPEATS || seconds < MIN_TEST_TIME) {
+            alg->init(S, n);
+            seconds += run_readers(alg, S, readers);
+            r++;
+        }
+        seconds /= r;
+        if (seconds < best_time) {
+            best_time = seconds;
+        }
+    }
+    alg->destroy(S);
+    printf("%.10e\n", best_time);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, name, n, best_time);
+    fclose(data_file);
+}
+
+value *sharded_input(int threads, value **ends) {
+    // The multi-threaded version of data.input, where thread t performs 
+    // in order the operations of data.input on elements in the shards 
+    // k with k * threads / shard_count(n) = t, i.e., each thread owns 
+    // contiguous shards; returns the operations of all threads, thread t's operations
+    // are [ends[t - 1], ends[t]), where ends[-1] is the returned array
+    value m = 0;
+    while (data.input[m] != 0) {
+        m++;
+    }
+    value *streams = malloc(m * sizeof(value)), *p = streams;
+    int shards = shard_count(data.n);
+    for (int t = 0; t < threads; t++) {
+        for (value *in = data.input; *in != 0; in++) {
+            value x = *in < 0 ? -*in : *in;
+            if (element_shard(data.n, x) * threads / shards == t) {
+                *(p++) = *in;
+            }
+        }
+        ends[t] = p;
+    }
+    return streams;
+}
+
+double run_sharded(const Algorithm *alg, void *S, int threads, const value *streams, value **ends) {
+    // Perform the operations of each thread in streams, and return the wall time used
+    pthread_t thread[MAX_THREADS];
+    thread_task task[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (int t = 0; t < threads; t++) {
+        task[t] = (thread_task) {alg, S, t == 0 ? streams : ends[t - 1], ends[t], &start, 0};
+        pthread_create(&thread[t], NULL, thread_run, &task[t]);
+    }
+    pthread_barrier_wait(&start);
+    double start_time = wall_time();
+    for (int t = 0; t < threads; t++) {
+        pthread_join(thread[t], NULL);
+        trash ^= task[t].trash;
+    }
+    double end_time = wall_time();
+    pthread_barrier_destroy(&start);
+    return end_time - start_time;
+}
+
+void time_it_sharded(const Algorithm *alg, int threads, const char *data_filename) {
+    // Time the sharded or concurrent algorithm alg on the test data in 
+    // data.input, where each thread performs the operations in its shards
+    assert((alg->sharded || alg->concurrent) && !data.extended && threads <= MAX_THREADS);
+    char name[300];
+    snprintf(name, sizeof(name), "%s, sharded, %d threads", data.name, threads);
+    if (skip_row(alg, "", name, data.n)) {
+        return;
+    }
+    validate(alg);
+    value n = data.n, *ends[MAX_THREADS];
+    value *streams = sharded_input(threads, ends);
+    void *S = alg->create(n);
+    void *R = alg_2pass.create(n);
+    alg->init(S, n);
+    alg_2pass.init(R, n);
+    run_sharded(alg, S, threads, streams, ends);
+    for (value *in = data.input; *in != 0; in++) {
+        if (*in < 0) {
+            alg_2pass.delete(R, -*in);
+        }
+    }
+    for (value i = 0; i < n + 2; i++) {
+        assert(alg->successor(S, i) == alg_2pass.successor(R, i));
+    }
+    alg_2pass.destroy(R);
+
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, name, n);
+    fflush(stdout);
+    double best_time = 1e100;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        double seconds = 0;
+        int r = 0;
+        while (r < MIN_REPEATS || seconds < MIN_TEST_TIME) {
+            alg->init(S, n);
+            seconds += run_sharded(alg, S, threads, streams, ends);
+            r++;
+        }
+        seconds /= r;
+        if (seconds < best_time) {
+            best_time = seconds;
+        }
+    }
+    alg->destroy(S);
+    free(streams);
+    printf("%.10e\n", best_time);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, name, n, best_time);
+    fclose(data_file);
+}
+
+int bitmap_bit(const word *bits, value i) {
+    return (bits[i / WORD_SIZE] >> (i % WORD_SIZE)) & 1;
+}
+
+void validate_set(const Algorithm *alg, void *S, value n, const word *bits) {
+    // Check if successor and predecessor queries on S agree with the set in bits
+    value s = n + 1;
+    for (value i = n + 1; i >= 0; i--) {
+        s = bitmap_bit(bits, i) ? i : s;
+        assert(alg->successor(S, i) == s);
+    }
+    if (alg->predecessor) {
+        value p = 0;
+        for (value i = 0; i < n + 2; i++) {
+            p = bitmap_bit(bits, i) ? i : p;
+            assert(alg->predecessor(S, i) == p);
+        }
+    }
+}
+
+void validate_build(const Algorithm *alg, value n, const word *bits) {
+    // Check if alg->build constructs the set in bits, and that the structure 
+    // remains correct under deletions
+    void *S = alg->create(n);
+    alg->build(S, n, bits);
+    validate_set(alg, S, n, bits);
+    value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    word *remaining = malloc(n_words * sizeof(word));
+    for (value w = 0; w < n_words; w++) {
+        remaining[w] = bits[w];
+    }
+    for (value i = 1; i <= n; i += 3) {
+        alg->delete(S, i);
+        remaining[i / WORD_SIZE] &= ~((word) 1 << (i % WORD_SIZE));
+    }
+    validate_set(alg, S, n, remaining);
+    free(remaining);
+    alg->destroy(S);
+}
+
+void time_it_build(const Algorithm *alg, value n, const word *bits, const char *name, const char *data_filename) {
+    // Time the construction of the set in bits by alg->build, and by 
+    // alg->init followed by deleting all values not in the set
+    char replay_name[300];
+    snprintf(replay_name, sizeof(replay_name), "replay %s", name);
+    if (skip_row(alg, "", replay_name, n)) {
+        return;  // the replay row is written last
+    }
+    validate_build(alg, n, bits);
+    void *S = alg->create(n);
+    for (int replay = 0; replay < 2; replay++) {
+        printf("\"%s%s\", \"%s %s\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, replay ? "replay" : "build", name, n);
+        fflush(stdout);
+        double best_time = 1e100;
+        for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+            double start = wall_time();
+            if (replay) {
+                alg->init(S, n);
+                for (value i = 1; i <= n; i++) {
+                    if (!bitmap_bit(bits, i)) {
+                        alg->delete(S, i);
+                    }
+                }
+            } else {
+                alg->build(S, n, bits);
+            }
+            double seconds = wall_time() - start;
+            if (seconds < best_time) {
+                best_time = seconds;
+            }
+        }
+        printf("%.10e\n", best_time);
+        FILE *data_file = fopen(data_filename, "a");
+        fprintf(data_file, "\"%s%s\", \"%s %s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, replay ? "replay" : "build", name, n, best_time);
+        fclose(data_file);
+    }
+    alg->destroy(S);
+}
+
+void time_it_sets(const Algorithm *alg, value k, const char *data_filename) {
+    // Time the algorithm alg on k independent sets, where each operation in 
+    // data.input is applied to all k sets before the next operation; the 
+    // time reported is per set
+    assert(!data.extended);
+    char name[300];
+    snprintf(name, sizeof(name), "%s, sets", data.name);
+    if (skip_row(alg, "", name, data.n)) {
+        return;
+    }
+    validate(alg);
+
+    void (*init)(void *, value)       = alg->init;
+    void (*delete)(void *, value)     = alg->delete;
+    value (*successor)(void *, value) = alg->successor;
+    value n                           = data.n;
+    value *input                      = data.input;
+    void **sets                       = malloc(k * sizeof(void *));
+    for (value s = 0; s < k; s++) {
+        sets[s] = alg->create(n);
+    }
+
+    printf("\"%s%s\", \"%s, sets\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    fflush(stdout);
+    measurement m, best = {.seconds = 1e100};
+    int r = 0, repeats = MIN_REPEATS;
+    for (int repeat_timing = 0; repeat_timing < BEST_OF; repeat_timing++) {
+        int first = r;  // runs before this timing
+        measure_start(&m);
+        while (1) {
+            for (; r < repeats; r++) {
+                for (value s = 0; s < k; s++) {
+                    init(sets[s], n);
+                }
+                for (value *in = input; *in != 0; in++) {
+                    value x = *in;
+                    if (x >= 0) {
+                        for (value s = 0; s < k; s++) {
+                            trash ^= successor(sets[s], x);
+                        }
+                    } else {
+                        for (value s = 0; s < k; s++) {
+                            delete(sets[s], -x);
+                        }
+                    }
+                }
+            }
+            measure_stop(&m);
+            if (m.seconds >= MIN_TEST_TIME) break;
+            repeats *= 2;
+        }
+        measure_scale(&m, (r - first) * k);
+        if (m.seconds < best.seconds) {
+            best = m;
+        }
+    }
+    for (value s = 0; s < k; s++) {
+        alg->destroy(sets[s]);
+    }
+    free(sets);
+    print_measurement(stdout, &best);
+    FILE *data_file = fopen(data_filename, "a");
+    fprintf(data_file, "\"%s%s\", \"%s, sets\", " VALUE_FORMAT ", ", alg->name, ROW_SUFFIX, data.name, n);
+    print_measurement(data_file, &best);
+    fclose(data_file);
+}
+
+// ================================================================
+//   Scheduler running the tests as independent jobs, either in order in
+//   this process, or in parallel by WORKERS worker processes, each pinned
+//   to its own CPU. Each job writes its rows to a separate file, and the
+//   files are appended to DATAFILE in job order when all jobs are done,
+//   so that DATAFILE only has a single writer and the same row order as
+//   running the jobs in order.
+// ================================================================
+
+int WORKERS = 1;                   // worker processes, 1 = run jobs in this process, option -w
+int ISOLATE_PHYSICAL_CORES = 1;    // use one CPU per physical core for workers
+value EXCLUSIVE_N = 1 << 22;       // jobs with n >= EXCLUSIVE_N run when no other job is running
+#define MAX_JOBS 1024              // max scheduled jobs
+
+typedef struct {
+    void (*run)(value, double);    // run(n, q)
+    value n;
+    double q;
+} job;
+
+job jobs[MAX_JOBS];
+int n_jobs = 0;
+
+void schedule(void (*run)(value, double), value n, double q) {
+    // Run job now if WORKERS == 1, otherwise when run_jobs is called
+    if (!selected_n(n)) {
+        return;
+    }
+    if (WORKERS <= 1) {
+        run(n, q);
+        return;
+    }
+    assert(n_jobs < MAX_JOBS);
+    jobs[n_jobs++] = (job) {run, n, q};
+}
+
+int worker_cpus(int *cpus) {
+    // CPUs for the workers, at most one for each physical core if 
+    // ISOLATE_PHYSICAL_CORES; returns the number of CPUs
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int n_cpus = 0;
+    long core[MAX_THREADS];  // package * 2^20 + core id of cpus[i]
+    for (int cpu = 0; cpu < online && n_cpus < MAX_THREADS; cpu++) {
+        long package = 0, id = cpu;
+        char filename[100];
+        sprintf(filename, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        FILE *f = fopen(filename, "r");
+        if (f != NULL) {
+            if (fscanf(f, "%ld", &package) != 1) package = 0;
+            fclose(f);
+        }
+        sprintf(filename, "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        f = fopen(filename, "r");
+        if (f != NULL) {
+            if (fscanf(f, "%ld", &id) != 1) id = cpu;
+            fclose(f);
+        }
+        int seen = 0;
+        for (int i = 0; i < n_cpus && ISOLATE_PHYSICAL_CORES; i++) {
+            seen |= core[i] == (package << 20) + id;
+        }
+        if (!seen) {
+            core[n_cpus] = (package << 20) + id;
+            cpus[n_cpus++] = cpu;
+        }
+    }
+    return n_cpus;
+}
+
+void job_filename(char *filename, int j, const char *extension) {
+    sprintf(filename, "%s.job%d.%s", DATAFILE, j, extension);
+}
+
+pid_t job_start(int j, int cpu) {
+    // Fork a worker running job j pinned to cpu, with rows written to 
+    // the job's csv file and output to the job's log file
+    fflush(stdout);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid > 0) {
+        return pid;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+    static char csv[300], log[300];
+    job_filename(csv, j, "csv");
+    job_filename(log, j, "log");
+    remove(csv);
+    FILE *f = fopen(csv, "w");  // a job may add no rows
+    if (f == NULL) {
+        fprintf(stderr, "Creating job file %s failed\n", csv);
+        _exit(EXIT_FAILURE);
+    }
+    fclose(f);
+    if (freopen(log, "w", stdout) == NULL) {
+        fprintf(stderr, "Redirecting job output to %s failed\n", log);
+        _exit(EXIT_FAILURE);
+    }
+    DATAFILE = csv;
+    jobs[j].run(jobs[j].n, jobs[j].q);
+    fflush(stdout);
+    _exit(0);
+}
+
+void job_merge(int j) {
+    // Append rows of job j to DATAFILE, and its output to stdout
+    char filename[300];
+    const char *extensions[2] = {"log", "csv"};
+    for (int e = 0; e < 2; e++) {
+        job_filename(filename, j, extensions[e]);
+        FILE *in = fopen(filename, "r");
+        assert(in != NULL);
+        FILE *out = e == 0 ? stdout : fopen(DATAFILE, "a");
+        char buffer[1 << 16];
+        size_t bytes;
+        while ((bytes = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+            fwrite(buffer, 1, bytes, out);
+        }
+        fclose(in);
+        if (e == 1) {
+            fclose(out);
+        }
+        remove(filename);
+    }
+    fflush(stdout);
+}
+
+int workers = 0;                   // workers in run_jobs
+pid_t running[MAX_THREADS];        // running[w] = pid of worker w, 0 = idle
+int running_job[MAX_THREADS];      // running_job[w] = job run by worker w
+int done[MAX_JOBS];                // done[j] = job j has finished
+int merged = 0;                    // jobs merged into DATAFILE
+
+int idle_workers() {
+    int idle = 0;
+    for (int w = 0; w < workers; w++) {
+        idle += running[w] == 0;
+    }
+    return idle;
+}
+
+void wait_job() {
+    // Wait for a worker to finish, and merge all finished jobs for which 
+    // all previous jobs have been merged
+    int status;
+    pid_t pid = wait(&status);
+    assert(pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    for (int w = 0; w < workers; w++) {
+        if (running[w] == pid) {
+            running[w] = 0;
+            done[running_job[w]] = 1;
+        }
+    }
+    for (; merged < n_jobs && done[merged]; merged++) {
+        job_merge(merged);
+    }
+}
+
+void run_jobs() {
+    // Run all scheduled jobs by the workers, where first all jobs with 
+    // n < EXCLUSIVE_N run in parallel, and then each remaining job alone;
+    // jobs are merged in job order as soon as all previous jobs are done,
+    // so that an interrupted run can be resumed from DATAFILE
+    if (n_jobs == 0) {
+        return;
+    }
+    int cpus[MAX_THREADS];
+    int n_cpus = worker_cpus(cpus);
+    workers = WORKERS < n_cpus ? WORKERS : n_cpus;
+    printf("Running %d jobs by %d workers\n", n_jobs, workers);
+    for (int w = 0; w < workers; w++) {
+        running[w] = 0;
+    }
+    for (int j = 0; j < n_jobs; j++) {
+        done[j] = 0;
+    }
+    merged = 0;
+    for (int exclusive = 0; exclusive < 2; exclusive++) {
+        for (int j = 0; j < n_jobs; j++) {
+            if ((jobs[j].n >= EXCLUSIVE_N) != exclusive) {
+                continue;
+            }
+            // Wait for an idle cpu, or for all cpus to be idle for exclusive jobs
+            while (exclusive ? idle_workers() < workers : idle_workers() == 0) {
+                wait_job();
+            }
+            int w = 0;
+            while (running[w] != 0) {
+                w++;
+            }
+            running_job[w] = j;
+            running[w] = job_start(j, cpus[w]);
+        }
+    }
+    while (idle_workers() < workers) {
+        wait_job();
+    }
+    assert(merged == n_jobs);
+    n_jobs = 0;
+}
+
+void job_query_one(value n, double q) {
+    data_query_one(n);
+    for (int s = 0; s < n_algorithms; s++) {
+        if (s == 0 && n > 65536) {
+            continue;  // naive algorithm too slow
+        }
+        time_it(&algorithms[s], DATAFILE);
+    }
+}
+
+void time_query_one() {
+    //  Run tests Delete(1), ..., Delete(n), n x Succ(1)
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_query_one, n, 0);
+    }
+}
+
+void job_worst_case(value n, double q) {
+    data_worst_case(n, q);
+    for (int s = 1; s < n_algorithms; s++) {
+        if (algorithms[s].successor == successor_2pass_bounded && n > 65536) {
+            continue;  // bounded compression has no amortized bound, too slow
+        }
+        time_it(&algorithms[s], DATAFILE);
+        if (LATENCY) {
+            time_latency(&algorithms[s], DATAFILE);
+        }
+    }
+}
+
+void time_worst_case() {
+    // Run tests Delete(1), ..., Delete(n), interleaved with worst-case queries
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        for (double q = 1.0 / 8; q <= 8; q *= 2) {
+            if (selected_alpha(q)) {
+                schedule(job_worst_case, n, q);
+            }
+        }
+    }
+}
+
+void job_random(value n, double unused) {
+    // One job for all q, sharing the cached random deletions
+    for (double q = 1.0 / 8; q <= 8; q *= 2) {
+        if (!selected_alpha(q)) {
+            continue;
+        }
+        data_random(n, q);
+        for (int s = 1; s < n_algorithms; s++) {
+            time_it(&algorithms[s], DATAFILE);
+            if (LATENCY) {
+                time_latency(&algorithms[s], DATAFILE);
+            }
+        }
+    }
+}
+
+void time_random() {
+    // Run tests with n random Delete, interleaved with worst-case queries
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_random, n, 0);
+    }
+}
+
+void job_many_sets(value n, double q) {
+    data_random(n, 1.0);
+    for (int s = 1; s < n_algorithms; s++) {
+        time_it_sets(&algorithms[s], MAX_N / n, DATAFILE);
+    }
+}
+
+void time_many_sets() {
+    // Run tests on MAX_N / n independent sets of size n, with n random Delete,
+    // interleaved with n worst-case queries
+    for (value n = SETS_MIN_N; n <= SETS_MAX_N && n <= MAX_N; n *= 2) {
+        schedule(job_many_sets, n, 0);
+    }
+}
+
+void job_batched(value n, double q) {
+    for (int i = 0; i < 2; i++) {
+        if (i == 0) {
+            data_query_one(n);
+        } else {
+            data_random(n, 8.0);
+        }
+        for (int s = 1; s < n_algorithms; s++) {
+            if (algorithms[s].successor_batch) {
+                time_it_batched(&algorithms[s], 0, DATAFILE);
+            }
+            if (algorithms[s].successor_sorted) {
+                time_it_batched(&algorithms[s], 1, DATAFILE);
+            }
+            if (algorithms[s].successor_step || algorithms[s].successor_batch) {
+                time_it_ring(&algorithms[s], DATAFILE);
+            }
+        }
+    }
+}
+
+void time_batched() {
+    // Run tests with batched operations on inputs with runs of queries
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_batched, n, 0);
+    }
+}
+
+void job_range(value n, double q) {
+    data_random(n, 1.0);
+    for (int s = 1; s < n_algorithms; s++) {
+        time_it_range(&algorithms[s], RANGE_K, DATAFILE);
+    }
+}
+
+void time_range() {
+    // Run tests with n random Delete, interleaved with n range queries for
+    // the next RANGE_K elements after the worst-case queries
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_range, n, 0);
+    }
+}
+
+void job_extents(value n, double q) {
+    for (value k = 16; k <= 1024 && 2 * k <= n; k *= 8) {
+        for (int elements = 0; elements < 2; elements++) {
+            data_extents(n, k, elements);
+            for (int s = 1; s < n_algorithms; s++) {
+                time_it(&algorithms[s], DATAFILE);
+            }
+        }
+    }
+}
+
+void time_extents() {
+    // Run tests with n / k deletions of random extents of k elements, each 
+    // followed by k worst-case queries, deleting each extent by a DeleteRange
+    // or by k Delete, where n must fit the packing of DeleteRange in data
+    for (value n = MIN_N; n <= MAX_N && n < (value) 1 << RANGE_SHIFT; n *= 2) {
+        schedule(job_extents, n, 0);
+    }
+}
+
+void job_inserts(value n, double q) {
+    data_inserts(n, 1.0);
+    for (int s = 1; s < n_algorithms; s++) {
+        if (algorithms[s].insert) {
+            time_it(&algorithms[s], DATAFILE);
+        }
+    }
+}
+
+void time_inserts() {
+    // Run tests on the random inputs with n random Delete and n worst-case 
+    // queries, with n / 2 Insert of earlier deletions, to be compared to 
+    // the delete-only structures on the same input without the Insert
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_inserts, n, 0);
+    }
+}
+
+void job_sparse(value n, double q) {
+    data_sparse(n, 8.0);
+    for (int s = 1; s < n_algorithms; s++) {
+        time_it(&algorithms[s], DATAFILE);
+        if (algorithms[s].successor_step) {
+            time_it_ring(&algorithms[s], DATAFILE);
+        }
+    }
+}
+
+void time_sparse() {
+    // Run tests with a phase deleting all but n / 16 random elements, 
+    // followed by a phase of 8n Succ of random elements in the sparse set
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_sparse, n, 0);
+    }
+}
+
+void job_dispatch(value n, double q) {
+    // The statically composed microsets with replay, and with the generic 
+    // microset operations calling the macroset through alg_macroset
+    data_random(n, 1.0);
+    for (int s = 1; s < n_algorithms; s++) {
+        const Algorithm *alg = &algorithms[s];
+        if (!alg->replay || skip_algorithm[s]) {
+            continue;
+        }
+        time_it_replay(alg, DATAFILE);
+        char name[200];
+        snprintf(name, sizeof(name), "%s, dispatch", alg->name);
+        Algorithm generic = *alg;
+        generic.name = name;
+        generic.delete = microset_delete;
+        generic.successor = microset_successor;
+        time_it(&generic, DATAFILE);
+    }
+}
+
+void time_dispatch() {
+    // Run tests on the random inputs with n random Delete and n worst-case
+    // queries, to be compared to the timings of the random test, reporting 
+    // the cost of the function pointer calls in time_it and in the microsets
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_dispatch, n, 0);
+    }
+}
+
+void job_mixed(value n, double q) {
+    data_mixed(n, q);
+    for (int s = 1; s < n_algorithms; s++) {
+        if (algorithms[s].predecessor) {
+            time_it(&algorithms[s], DATAFILE);
+        }
+    }
+}
+
+void job_stream(value n, double q) {
+    for (int s = 1; s < n_algorithms; s++) {
+        time_it_stream(&algorithms[s], n, 1.0, DATAFILE);
+    }
+}
+
+void time_stream() {
+    // Run tests with n random Delete, interleaved with n random queries, for
+    // STREAM_MIN_N <= n <= STREAM_MAX_N, where the operations are streamed
+    if (!selected_alpha(1.0)) {
+        return;
+    }
+    for (value n = STREAM_MIN_N; n <= STREAM_MAX_N; n *= 2) {
+        schedule(job_stream, n, 0);
+    }
+}
+
+void job_allocator(value n, double q) {
+    // One job for the allocator-style inputs, where only the structures 
+    // supporting Insert free in LIFO order
+    void (*generators[3])(value) = {data_zipf, data_frontier, data_window};
+    for (int g = 0; g < 3; g++) {
+        generators[g](n);
+        for (int s = 1; s < n_algorithms; s++) {
+            time_it(&algorithms[s], DATAFILE);
+        }
+    }
+    data_lifo(n);
+    for (int s = 1; s < n_algorithms; s++) {
+        if (algorithms[s].insert) {
+            time_it(&algorithms[s], DATAFILE);
+        }
+    }
+}
+
+void time_allocator() {
+    // Run tests with allocations by Succ and Delete with clustered hints
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        schedule(job_allocator, n, 0);
+    }
+}
+
+void time_mixed() {
+    // Run tests with n random Delete, interleaved with worst-case Succ and Pred queries
+    for (value n = MIN_N; n <= MAX_N; n *= 2) {
+        for (double q = 1.0 / 8; q <= 8; q *= 2) {
+            if (selected_alpha(q)) {
+                schedule(job_mixed, n, q);
+            }
+        }
+    }
+}
+
+void time_threads() {
+    // Run tests with n random Delete, interleaved with worst-case queries, 
+    // partitioned among 1, 2, 4, ... threads up to the number of cores
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (value n = THREADS_MIN_N; n <= MAX_N; n *= 4) {
+        if (!selected_n(n)) {
+            continue;
+        }
+        data_random(n, 1.0);
+        for (int threads = 1; threads <= MAX_THREADS && threads <= cores; threads *= 2) {
+            for (int s = 1; s < n_algorithms; s++) {
+                if (algorithms[s].concurrent) {
+                    time_it_threads(&algorithms[s], threads, DATAFILE);
+                }
+            }
+        }
+    }
+}
+
+void time_readers() {
+    // Run tests with n random Delete by a single writer, and 8n worst-case
+    // queries partitioned among 1, 2, 4, ... readers up to the number of 
+    // cores minus the writer
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (value n = THREADS_MIN_N; n <= MAX_N; n *= 4) {
+        if (!selected_n(n)) {
+            continue;
+        }
+        data_random(n, 8.0);
+        for (int readers = 1; readers < MAX_THREADS && (readers == 1 || readers < cores); readers *= 2) {
+            for (int s = 1; s < n_algorithms; s++) {
+                if (algorithms[s].concurrent || algorithms[s].snapshot_successor) {
+                    time_it_readers(&algorithms[s], readers, DATAFILE);
+                }
+            }
+        }
+    }
+}
+
+void time_sharded() {
+    // Run tests with n random Delete, interleaved with worst-case queries, 
+    // where the operations are partitioned among 1, 2, 4, ... threads up to
+    // the number of cores by the shards of their elements
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (value n = THREADS_MIN_N; n <= MAX_N; n *= 4) {
+        if (!selected_n(n)) {
+            continue;
+        }
+        data_random(n, 1.0);
+        for (int threads = 1; threads <= MAX_THREADS && threads <= cores; threads *= 2) {
+            for (int s = 1; s < n_algorithms; s++) {
+                if (algorithms[s].sharded || algorithms[s].concurrent) {
+                    time_it_sharded(&algorithms[s], threads, DATAFILE);
+                }
+            }
+        }
+    }
+}
+
+void time_build() {
+    // Run tests constructing random sets with density 1/8 from a bitmap,
+    // where 4n does not overflow, since -B bounds BUILD_MAX_N like -N
+    for (value n = BUILD_MIN_N; n <= BUILD_MAX_N; n *= 4) {
+        if (!selected_n(n)) {
+            continue;
+        }
+        printf("Creating random bitmap: n = " VALUE_FORMAT "\n", n);
+        word *bits = bitmap_random(n, 3);
+        for (int s = 0; s < n_algorithms; s++) {
+            if (algorithms[s].build) {
+                time_it_build(&algorithms[s], n, bits, "0.125", DATAFILE);
+            }
+        }
+        free(bits);
+    }
+}
+
+void time_persistent_row(const Algorithm *alg, const char *name, value n, double seconds) {
+    printf("\"%s%s\", \"%s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, name, n, seconds);
+    FILE *data_file = fopen(DATAFILE, "a");
+    fprintf(data_file, "\"%s%s\", \"%s\", " VALUE_FORMAT ", %.10e\n", alg->name, ROW_SUFFIX, name, n, seconds);
+    fclose(data_file);
+}
+
+void time_persistent() {
+    // Time creating a persistent structure, deleting every third value, 
+    // closing it, and reopening it, and validate the reopened structure
+    value n = MAX_N;
+    if (!selected_n(n)) {
+        return;
+    }
+    value n_words = (n + 2 + WORD_SIZE - 1) / WORD_SIZE;
+    word *bits = malloc(n_words * sizeof(word));
+    for (value w = 0; w < n_words; w++) {
+        bits[w] = (word) -1;
+    }
+    if ((n + 2) % WORD_SIZE != 0) {
+        bits[n_words - 1] = ((word) 1 << ((n + 2) % WORD_SIZE)) - 1;
+    }
+    for (value i = 1; i <= n; i += 3) {
+        bits[i / WORD_SIZE] &= ~((word) 1 << (i % WORD_SIZE));
+    }
+    for (int s = 0; s < n_algorithms; s++) {
+        const Algorithm *alg = &algorithms[s];
+        if (skip_row(alg, "", "persistent reopen", n)) {
+            continue;  // the reopen row is written last
+        }
+        unlink(STOREFILE);
+        double start = wall_time();
+        store *P = store_open(STOREFILE, alg, n, n);
+        assert(P != NULL && !P->reopened);
+        time_persistent_row(alg, "persistent open", n, wall_time() - start);
+        for (value i = 1; i <= n; i += 3) {
+            alg->delete(P->S, i);
+        }
+        for (value i = 0; i <= n; i++) {
+            alg->successor(P->S, i);
+        }
+        start = wall_time();
+        store_close(P);
+        time_persistent_row(alg, "persistent close", n, wall_time() - start);
+        start = wall_time();
+        P = store_open(STOREFILE, alg, n, n);
+        assert(P != NULL && P->reopened);
+        time_persistent_row(alg, "persistent reopen", n, wall_time() - start);
+        validate_set(alg, P->S, n, bits);
+        store_close(P);
+    }
+    unlink(STOREFILE);
+    free(bits);
+}
+
+void time_traces() {
+    // Write test data to a trace file, and time streaming replay of the
+    // trace, to be compared to the timings of the same data from data.input,
+    // and time replay of the recorded trace REPLAY_TRACE for the structures
+    // supporting its operations
+    if (REPLAY_TRACE != NULL) {
+        trace *T = trace_open(REPLAY_TRACE);
+        assert(T != NULL);
+        int preds, inserts;
+        trace_operations(T, &preds, &inserts);
+        trace_close(T);
+        for (int s = 1; s < n_algorithms; s++) {
+            if ((!preds || algorithms[s].predecessor) && (!inserts || algorithms[s].insert)) {
+                time_it_trace(&algorithms[s], REPLAY_TRACE, DATAFILE);
+            }
+        }
+    }
+    if (!selected_n(MAX_N)) {
+        return;
+    }
+    data_random(MAX_N, 1.0);
+    trace_write(TRACEFILE, 1);
+    int read = data_read(TRACEFILE);
+    assert(read);
+    for (int s = 1; s < n_algorithms; s++) {
+        time_it_trace(&algorithms[s], TRACEFILE, DATAFILE);
+    }
+    unlink(TRACEFILE);
+}
+
+// ================================================================
+//   Main
+// ================================================================
+
+void resume() {
+    // Resume an interrupted run by removing an incomplete last row from
+    // DATAFILE, appending the complete rows of unmerged jobs, and reading
+    // the rows in DATAFILE, which are then skipped by skip_row
+    FILE *f = fopen(DATAFILE, "r");
+    if (f == NULL) {
+        return;
+    }
+    long complete = 0;  // length of complete rows
+    for (int c; (c = fgetc(f)) != EOF; ) {
+        if (c == '\n') {
+            complete = ftell(f);
+        }
+    }
+    fclose(f);
+    if (truncate(DATAFILE, complete) != 0) {
+        fprintf(stderr, "Removing the incomplete last row of %s failed\n", DATAFILE);
+        exit(EXIT_FAILURE);
+    }
+    FILE *out = fopen(DATAFILE, "a");
+    char line[4096], filename[300];
+    for (int j = 0; j < MAX_JOBS; j++) {
+        job_filename(filename, j, "log");
+        remove(filename);
+        job_filename(filename, j, "csv");
+        FILE *in = fopen(filename, "r");
+        if (in == NULL) {
+            continue;
+        }
+        while (fgets(line, sizeof(line), in) != NULL) {
+            if (line[strlen(line) - 1] == '\n') {
+                fputs(line, out);
+            }
+        }
+        fclose(in);
+        remove(filename);
+    }
+    fclose(out);
+    f = fopen(DATAFILE, "r");
+    value capacity = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] != '"') {
+            continue;
+        }
+        if (n_done_rows == capacity) {
+            capacity = 2 * capacity + 1024;
+            done_rows = realloc(done_rows, capacity * sizeof(char *));
+        }
+        done_rows[n_done_rows++] = strdup(line);
+    }
+    fclose(f);
+    qsort(done_rows, n_done_rows, sizeof(char *), compare_rows);
+    printf("Resuming, skipping %lld rows in %s\n", (long long) n_done_rows, DATAFILE);
+}
+
+
+const int n_tests = 19;
+const char *tests[19] = {"random", "query_one", "worst_case", "many_sets", "batched", "mixed", "range", "extents", "inserts", "sparse", "dispatch", "threads", "readers", "sharded", "build", "persistent", "traces", "stream", "allocator"};
+int skip_test[19];  // skip_test[t] = tests[t] not selected
+
+int selected_test(const char *name) {
+    for (int t = 0; t < n_tests; t++) {
+        if (strcmp(tests[t], name) == 0) {
+            return !skip_test[t];
+        }
+    }
+    assert(0);
+    return 0;
+}
+
+void usage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -a name    run algorithm name, can be repeated (default all)\n");
+    printf("  -t test    run test, can be repeated (default all)\n");
+    printf("  -n from:to only tests with from <= n <= to, e.g. 2^20: (default all)\n");
+    printf("  -q alphas  only tests with alpha in comma separated list, e.g. 1/8,1,8 (default all)\n");
+    printf("  -N n       max set size (default " VALUE_FORMAT ")\n", MAX_N);
+    printf("  -B n       max set size in the build test (default " VALUE_FORMAT ")\n", BUILD_MAX_N);
+    printf("  -S n       max set size in the stream test (default " VALUE_FORMAT ")\n", STREAM_MAX_N);
+    printf("  -T time    min test time in seconds (default %g)\n", MIN_TEST_TIME);
+    printf("  -o file    data file (default %s)\n", DATAFILE);
+    printf("  -w workers worker processes for single-threaded tests (default %d)\n", WORKERS);
+    printf("  -c folder  cache generated test data as traces in folder\n");
+    printf("  -R file    replay the recorded trace in file in the traces test\n");
+    printf("  -m policy  memory policy, comma separated list of thp, hugetlb2m, hugetlb1g,\n");
+    printf("             interleave and align (default malloc)\n");
+    printf("  -r         resume, skip rows already in the data file\n");
+    printf("  -l         list algorithms and tests\n");
+    exit(EXIT_FAILURE);
+}
+
+value parse_n(const char *s) {
+    // Parse n given as an integer or 2^k, the empty string is 0
+    char *end;
+    value n = strtoll(s, &end, 10);
+    if (*end == '^') {
+        value k = strtoll(end + 1, &end, 10);
+        n = n == 2 && k >= 0 && k < 8 * (value) sizeof(value) - 1 ? (value) 1 << k : -1;
+    }
+    if (*end != '\0' && *end != ':' && *end != ',') {
+        return -1;
+    }
+    return n;
+}
+
+double parse_alpha(const char *s, char **end) {
+    // Parse alpha given as a number or a fraction a/b
+    double q = strtod(s, end);
+    if (**end == '/') {
+        q /= strtod(*end + 1, end);
+    }
+    return q;
+}
+
+void parse_options(int argc, char **argv) {
+    int any_algorithm = 0, any_test = 0;
+    const char *program = argv[0];
+    int c;
+    while ((c = getopt(argc, argv, "a:t:n:q:N:B:S:T:o:w:c:R:m:rlh")) != -1) {
+        if (c == 'a' || c == 't') {
+            int found = 0;
+            int *any = c == 'a' ? &any_algorithm : &any_test;
+            int *skip = c == 'a' ? skip_algorithm : skip_test;
+            int count = c == 'a' ? n_algorithms : n_tests;
+            if (!*any) {
+                for (int i = 0; i < count; i++) {
+                    skip[i] = 1;
+                }
+                *any = 1;
+            }
+            for (int i = 0; i < count; i++) {
+                if (strcmp(c == 'a' ? algorithms[i].name : tests[i], optarg) == 0) {
+                    skip[i] = 0;
+                    found = 1;
+                }
+            }
+            if (!found) {
+                fprintf(stderr, "Unknown %s: %s (use -l to list)\n", c == 'a' ? "algorithm" : "test", optarg);
+                exit(EXIT_FAILURE);
+            }
+        } else if (c == 'n') {
+            const char *colon = strchr(optarg, ':');
+            FROM_N = parse_n(optarg);
+            TO_N = colon == NULL ? FROM_N : parse_n(colon + 1);
+            if (FROM_N < 0 || TO_N < 0) {
+                usage(program);
+            }
+        } else if (c == 'q') {
+            char *s = optarg;
+            n_alphas = 0;
+            while (n_alphas < MAX_ALPHAS) {
+                alphas[n_alphas++] = parse_alpha(s, &s);
+                if (*s != ',') {
+                    break;
+                }
+                s++;
+            }
+            if (*s != '\0') {
+                usage(program);
+            }
+        } else if (c == 'N') {
+            MAX_N = parse_n(optarg);
+            if (MAX_N < MIN_N || MAX_N > ((value) 1 << (8 * sizeof(value) - 5))) {
+                usage(program);
+            }
+        } else if (c == 'B') {
+            BUILD_MAX_N = parse_n(optarg);
+            if (BUILD_MAX_N < MIN_N || BUILD_MAX_N > ((value) 1 << (8 * sizeof(value) - 5))) {
+                usage(program);
+            }
+        } else if (c == 'S') {
+            STREAM_MAX_N = parse_n(optarg);
+            if (STREAM_MAX_N < MIN_N || STREAM_MAX_N > ((value) 1 << (8 * sizeof(value) - 5))) {
+                usage(program);
+            }
+        } else if (c == 'T') {
+            MIN_TEST_TIME = atof(optarg);
+        } else if (c == 'o') {
+            DATAFILE = optarg;
+        } else if (c == 'w') {
+            WORKERS = atoi(optarg);
+        } else if (c == 'c') {
+            TRACE_FOLDER = optarg;
+        } else if (c == 'R') {
+            REPLAY_TRACE = optarg;
+        } else if (c == 'm') {
+            memory_policy(optarg);
+        } else if (c == 'r') {
+            RESUME = 1;
+        } else if (c == 'l') {
+            for (int s = 0; s < n_algorithms; s++) {
+                printf("algorithm: %s\n", algorithms[s].name);
+            }
+            for (int t = 0; t < n_tests; t++) {
+                printf("test: %s\n", tests[t]);
+            }
+            exit(EXIT_SUCCESS);
+        } else {
+            usage(program);
+        }
+    }
+    if (optind < argc) {
+        usage(program);
+    }
+}
+
+int main(int argc, char **argv) {
+    parse_options(argc, argv);
+    if (RESUME) {
+        resume();
+    }
+    printf("Values are %zu byte integers\n", sizeof(value));
+    simd_dispatch();
+    printf("Microset scans use %s\n", scan_words_kernel);
+    
+    // Allocate space for the test data generators, the successor-delete
+    // structures are created by each timing
+    memory_free(memory_malloc(MAPPED_MIN_SIZE));  // fail now if the memory policy is unavailable
+    MAX_OPERATIONS = 9 * MAX_N + 1;
+    T_allocate(MAX_N);
+    data_allocate(MAX_OPERATIONS);
+
+    // Run the selected tests, where the single-threaded tests are run as jobs 
+    // by run_jobs if WORKERS > 1
+    if (selected_test("random")) time_random();
+    if (selected_test("query_one")) time_query_one();
+    if (selected_test("worst_case")) time_worst_case();
+    if (selected_test("many_sets")) time_many_sets();
+    if (selected_test("batched")) time_batched();
+    if (selected_test("mixed")) time_mixed();
+    if (selected_test("range")) time_range();
+    if (selected_test("extents")) time_extents();
+    if (selected_test("inserts")) time_inserts();
+    if (selected_test("sparse")) time_sparse();
+    if (selected_test("dispatch")) time_dispatch();
+    if (selected_test("stream")) time_stream();
+    if (selected_test("allocator")) time_allocator();
+    run_jobs();
+    if (selected_test("threads")) time_threads();
+    if (selected_test("readers")) time_readers();
+    if (selected_test("sharded")) time_sharded();
+    if (selected_test("build")) time_build();
+    if (selected_test("persistent")) time_persistent();
+    if (selected_test("traces")) time_traces();
+
+    printf("Trash (ignore): " VALUE_FORMAT "\n", trash);
+}
+
+// ================================================================